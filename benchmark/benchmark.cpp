@@ -0,0 +1,190 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../header/ga.h"
+#include "../header/timetable.h"
+#include "../header/validator.h"
+
+using namespace std;
+
+// Runs the GA on a set of instances with fixed seeds and reports throughput,
+// decoder time, time-to-target and the validator's cost of every run.
+//
+// The target of an instance is fixed, so times stay comparable between builds
+// and settings: the instance's line in the target file (-f, "<instance> <fitness>"
+// per line, instance by file stem), else the fitness given with -g. Without
+// either it falls back to the worst final fitness over its repetitions, which
+// every repetition reaches but which moves with the results being measured.
+// Runs that never reach the target report their whole run time and reached = 0.
+
+struct BenchmarkRun {
+    string instance;
+    unsigned repetition, seed;
+    RunStats stats;
+    int fitness;
+    unsigned validated_cost, violations;
+    int target = 0;
+    double time_to_target = 0;
+    bool reached = false;
+};
+
+// Seconds until the best fitness first got to target, or the whole run if it never did
+double time_to(const RunStats& stats, int target, bool& reached) {
+    reached = true;
+    for (const auto& point : stats.trace)
+        if (point.second <= target) return point.first;
+    reached = false;
+    return stats.seconds;
+}
+
+bool read_targets(const string& file_name, map<string, int>& targets) {
+    ifstream is(file_name.c_str());
+    string line, instance;
+    int target;
+    if (!is) return false;
+    while (getline(is, line)) {
+        istringstream fields(line);
+        if (fields >> instance >> target && instance[0] != '#') targets[instance] = target;
+    }
+    return true;
+}
+
+void write_csv(ostream& os, const vector<BenchmarkRun>& runs, const GAParameters& params) {
+    os << "instance,repetition,seed,threads,generations,population,evaluations,seconds,evaluations_per_second,"
+       << "decode_seconds,decode_us_per_evaluation,fitness,validated_cost,violations,target,time_to_target,reached\n";
+    for (const auto& r : runs) {
+        os << r.instance << ',' << r.repetition << ',' << r.seed << ',' << params.threads << ',' << params.max_generations << ','
+           << params.pop_size << ',' << r.stats.evaluations << ',' << r.stats.seconds << ',' << r.stats.evaluations / r.stats.seconds << ','
+           << r.stats.decode_seconds << ',' << 1e6 * r.stats.decode_seconds / r.stats.evaluations << ',' << r.fitness << ','
+           << r.validated_cost << ',' << r.violations << ',' << r.target << ',' << r.time_to_target << ',' << r.reached << '\n';
+    }
+}
+
+void write_json(ostream& os, const vector<BenchmarkRun>& runs, const GAParameters& params) {
+    os << "{\n  \"threads\": " << params.threads << ",\n  \"generations\": " << params.max_generations
+       << ",\n  \"population\": " << params.pop_size << ",\n  \"runs\": [";
+    for (size_t i = 0; i < runs.size(); i++) {
+        const BenchmarkRun& r = runs[i];
+        os << (i ? "," : "") << "\n    {\"instance\": \"" << r.instance << "\", \"repetition\": " << r.repetition
+           << ", \"seed\": " << r.seed << ", \"evaluations\": " << r.stats.evaluations << ", \"seconds\": " << r.stats.seconds
+           << ", \"evaluations_per_second\": " << r.stats.evaluations / r.stats.seconds
+           << ", \"decode_seconds\": " << r.stats.decode_seconds
+           << ", \"decode_us_per_evaluation\": " << 1e6 * r.stats.decode_seconds / r.stats.evaluations
+           << ", \"fitness\": " << r.fitness << ", \"validated_cost\": " << r.validated_cost << ", \"violations\": " << r.violations
+           << ", \"target\": " << r.target << ", \"time_to_target\": " << r.time_to_target
+           << ", \"reached\": " << (r.reached ? "true" : "false") << "}";
+    }
+    os << "\n  ]\n}\n";
+}
+
+int main(int argc, char* argv[]) {
+    GAParameters params;
+    unsigned repetitions = 3;
+    string solution_dir = "output/benchmark", json_file, csv_file, target_file;
+    vector<string> instances;
+    map<string, int> targets;
+    bool fixed_target = false;
+    int target_fitness = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (argv[i][0] == '-' && i + 1 >= argc) {
+            cerr << "Usage: " << argv[0] << " [-r repetitions] [-s seed] [-t threads] [-G generations] [-P population]"
+                 << " [-g target_fitness] [-f target_file] [-d solution_dir] [-j json_file] [-c csv_file] [instance ...]" << endl;
+            return 1;
+        }
+        if (strcmp(argv[i], "-r") == 0) repetitions = strtoul(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "-s") == 0) params.seed = strtoul(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "-t") == 0) params.threads = strtoul(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "-G") == 0) params.max_generations = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-P") == 0) params.pop_size = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-g") == 0) {
+            target_fitness = atoi(argv[++i]);
+            fixed_target = true;
+        }
+        else if (strcmp(argv[i], "-f") == 0) target_file = argv[++i];
+        else if (strcmp(argv[i], "-d") == 0) solution_dir = argv[++i];
+        else if (strcmp(argv[i], "-j") == 0) json_file = argv[++i];
+        else if (strcmp(argv[i], "-c") == 0) csv_file = argv[++i];
+        else instances.push_back(argv[i]);
+    }
+    if (params.threads == 0) params.threads = 1;
+    if (repetitions == 0) repetitions = 1;
+    if (!target_file.empty() && !read_targets(target_file, targets)) {
+        cerr << "Cannot read target file " << target_file << endl;
+        return 1;
+    }
+
+    if (instances.empty()) {
+        for (const auto& entry : filesystem::directory_iterator("data")) {
+            string file = entry.path().string();
+            if (entry.path().filename().string().rfind("comp", 0) == 0 && entry.path().extension() == ".ctt")
+                instances.push_back(file);
+        }
+        sort(instances.begin(), instances.end());
+    }
+    filesystem::create_directories(solution_dir);
+
+    vector<BenchmarkRun> runs;
+    cout << left << setw(10) << "instance" << right << setw(5) << "rep" << setw(12) << "evals/s" << setw(12) << "decode us"
+         << setw(10) << "fitness" << setw(10) << "cost" << setw(8) << "viol" << setw(10) << "seconds" << endl;
+
+    for (const auto& instance : instances) {
+        Faculty faculty(instance);
+        string stem = filesystem::path(instance).stem().string();
+        size_t first = runs.size();
+
+        for (unsigned rep = 0; rep < repetitions; rep++) {
+            BenchmarkRun run;
+            GAParameters p = params;
+            p.seed = params.seed + rep;
+            run.instance = stem;
+            run.repetition = rep;
+            run.seed = p.seed;
+
+            Population population = run_ga(faculty, p, run.stats);
+            run.fitness = population[0].fitness;
+
+            string solution = solution_dir + "/" + stem + "_" + to_string(rep) + ".out";
+            write_solution(population[0], faculty, solution);
+            Timetable timetable(faculty, solution);
+            Validator validator(faculty, timetable);
+            run.validated_cost = validator.TotalCost();
+            run.violations = validator.TotalViolations();
+
+            cout << left << setw(10) << stem << right << setw(5) << rep << setw(12) << fixed << setprecision(0)
+                 << run.stats.evaluations / run.stats.seconds << setw(12) << setprecision(1)
+                 << 1e6 * run.stats.decode_seconds / run.stats.evaluations << setw(10) << run.fitness << setw(10) << run.validated_cost
+                 << setw(8) << run.violations << setw(10) << setprecision(3) << run.stats.seconds << endl;
+            runs.push_back(run);
+        }
+
+        int target = INT_MIN;
+        if (targets.count(stem)) target = targets[stem];
+        else if (fixed_target) target = target_fitness;
+        else
+            for (size_t i = first; i < runs.size(); i++) target = max(target, runs[i].fitness);
+        for (size_t i = first; i < runs.size(); i++) {
+            runs[i].target = target;
+            runs[i].time_to_target = time_to(runs[i].stats, target, runs[i].reached);
+        }
+    }
+
+    cout.unsetf(ios::floatfield);
+    if (!csv_file.empty()) {
+        ofstream os(csv_file.c_str());
+        write_csv(os, runs, params);
+    }
+    if (!json_file.empty()) {
+        ofstream os(json_file.c_str());
+        write_json(os, runs, params);
+    }
+    return 0;
+}
@@ -0,0 +1,41 @@
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include "../header/generator.h"
+
+using namespace std;
+
+// Writes a synthetic ITC-2007 instance; see GeneratorParameters for the defaults
+int main(int argc, char* argv[]) {
+    GeneratorParameters g;
+    int i;
+
+    for (i = 2; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "-c") == 0) g.courses = strtoul(argv[i + 1], nullptr, 10);
+        else if (strcmp(argv[i], "-r") == 0) g.rooms = strtoul(argv[i + 1], nullptr, 10);
+        else if (strcmp(argv[i], "-d") == 0) g.days = strtoul(argv[i + 1], nullptr, 10);
+        else if (strcmp(argv[i], "-p") == 0) g.periods_per_day = strtoul(argv[i + 1], nullptr, 10);
+        else if (strcmp(argv[i], "-q") == 0) g.curricula = strtoul(argv[i + 1], nullptr, 10);
+        else if (strcmp(argv[i], "-k") == 0) g.curriculum_size = strtoul(argv[i + 1], nullptr, 10);
+        else if (strcmp(argv[i], "-o") == 0) g.overlap = atof(argv[i + 1]);
+        else if (strcmp(argv[i], "-t") == 0) g.teacher_sharing = atof(argv[i + 1]);
+        else if (strcmp(argv[i], "-u") == 0) g.unavailability = atof(argv[i + 1]);
+        else if (strcmp(argv[i], "-l") == 0) g.load = atof(argv[i + 1]);
+        else if (strcmp(argv[i], "-s") == 0) g.seed = strtoull(argv[i + 1], nullptr, 10);
+        else break;
+    }
+    if (argc < 2 || i != argc || g.courses == 0 || g.rooms == 0 || g.days == 0 || g.periods_per_day == 0) {
+        cerr << "Usage: " << argv[0] << " <output.ctt> [-c courses] [-r rooms] [-d days] [-p periods_per_day] [-q curricula]"
+             << " [-k curriculum_size] [-o overlap] [-t courses_per_teacher] [-u unavailability] [-l load] [-s seed]" << endl;
+        return 1;
+    }
+
+    ofstream os(argv[1]);
+    write_instance(os, g);
+    if (!os) {
+        cerr << "Failed to write " << argv[1] << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,172 @@
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../header/ga.h"
+#include "../header/generator.h"
+#include "../header/timetable.h"
+#include "../header/validator.h"
+
+using namespace std;
+
+// Generates synthetic instances of growing size and times, at every size:
+// loading the .ctt, decoding a chromosome, scoring the timetable (BatchScorer and
+// CostEngine), a whole evaluation as the GA runs it and validating a solution
+// file. Times are per call, averaged over random chromosomes. Between
+// consecutive sizes the growth exponent log(t2 / t1) / log(n2 / n1) against the
+// number of lectures is printed; steps above 1.2 are marked as super-linear.
+
+struct ScalingPoint {
+    unsigned courses, rooms, curricula, events, conflict_edges;
+    double load_ms, decode_us, score_us, engine_us, evaluate_us, validate_ms;
+};
+
+static const int COLUMNS = 6;
+static const char* const COLUMN_NAMES[COLUMNS] = {"load", "decode", "score", "engine", "evaluate", "validate"};
+
+static double column(const ScalingPoint& s, int k) {
+    const double values[COLUMNS] = {s.load_ms, s.decode_us, s.score_us, s.engine_us, s.evaluate_us, s.validate_ms};
+    return values[k];
+}
+
+template <typename F>
+double seconds_of(F f) {
+    auto start = chrono::steady_clock::now();
+    f();
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+ScalingPoint measure(const string& file, const GeneratorParameters& g, unsigned samples) {
+    ScalingPoint s;
+    s.courses = g.courses;
+    s.rooms = g.rooms;
+    s.curricula = g.curricula;
+
+    unique_ptr<Faculty> loaded;
+    s.load_ms = 1e3 * seconds_of([&] { loaded.reset(new Faculty(file)); });
+    const Faculty& faculty = *loaded;
+    s.events = faculty.Events();
+    s.conflict_edges = faculty.ConflictEdges();
+
+    Rng rng(g.seed);
+    vector<Individual> individuals(samples);
+    for (auto& ind : individuals) ind = gen_random_individual(faculty, rng);
+
+    Occupancy occupancy(faculty);
+    CostEngine engine(faculty);
+    BatchScorer scorer(faculty);
+    Worker worker(faculty, g.seed, 0);
+    long checksum = 0;
+
+    s.decode_us = 1e6 / samples * seconds_of([&] {
+        for (auto& ind : individuals) decode_individual(ind, faculty, occupancy, ind.assignments);
+    });
+    s.score_us = 1e6 / samples * seconds_of([&] {
+        for (const auto& ind : individuals) checksum += scorer.Score(ind.assignments);
+    });
+    s.engine_us = 1e6 / samples * seconds_of([&] {
+        for (const auto& ind : individuals) checksum -= score_assignments(ind.assignments, engine);
+    });
+    if (checksum != 0) cerr << "BatchScorer and CostEngine disagree on " << file << endl;
+    s.evaluate_us = 1e6 / samples * seconds_of([&] {
+        for (auto& ind : individuals) checksum += worker.Evaluate(ind);
+    });
+
+    string solution = file + ".out";
+    write_solution(individuals[0], faculty, solution);
+    unsigned runs = max(1u, samples / 20);
+    s.validate_ms = 1e3 / runs * seconds_of([&] {
+        for (unsigned k = 0; k < runs; k++) {
+            Timetable timetable(faculty, solution);
+            Validator validator(faculty, timetable);
+            checksum += validator.TotalCost();
+        }
+    });
+    return s;
+}
+
+int main(int argc, char* argv[]) {
+    GeneratorParameters base;
+    unsigned steps = 6, samples = 200;
+    double factor = 2;
+    string dir = "output/scaling", csv_file;
+    base.courses = 250;
+    base.rooms = 15;
+    base.curricula = 100;
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc) {
+            cerr << "Usage: " << argv[0] << " [-c courses] [-r rooms] [-q curricula] [-f factor] [-n steps] [-k samples]"
+                 << " [-d instance_dir] [-o csv_file]" << endl;
+            return 1;
+        }
+        if (strcmp(argv[i], "-c") == 0) base.courses = strtoul(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "-r") == 0) base.rooms = strtoul(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "-q") == 0) base.curricula = strtoul(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "-f") == 0) factor = atof(argv[++i]);
+        else if (strcmp(argv[i], "-n") == 0) steps = strtoul(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "-k") == 0) samples = strtoul(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "-d") == 0) dir = argv[++i];
+        else if (strcmp(argv[i], "-o") == 0) csv_file = argv[++i];
+        else {
+            cerr << "Unknown option " << argv[i] << endl;
+            return 1;
+        }
+    }
+    if (samples == 0) samples = 1;
+    filesystem::create_directories(dir);
+
+    // Courses, rooms and curricula grow together, so lectures per room-period stay the same
+    vector<ScalingPoint> points;
+    cout << right << setw(8) << "courses" << setw(9) << "lectures" << setw(10) << "edges" << setw(10) << "load ms" << setw(11) << "decode us"
+         << setw(10) << "score us" << setw(11) << "engine us" << setw(10) << "eval us" << setw(13) << "validate ms" << endl;
+    for (unsigned k = 0; k < steps; k++) {
+        GeneratorParameters g = base;
+        double scale = pow(factor, k);
+        g.courses = unsigned(base.courses * scale);
+        g.rooms = max(1u, unsigned(base.rooms * scale));
+        g.curricula = unsigned(base.curricula * scale);
+        string file = dir + "/synthetic_" + to_string(g.courses) + ".ctt";
+        {
+            ofstream os(file.c_str());
+            write_instance(os, g);
+        }
+
+        ScalingPoint s = measure(file, g, samples);
+        cout << setw(8) << s.courses << setw(9) << s.events << setw(10) << s.conflict_edges << fixed << setprecision(2) << setw(10)
+             << s.load_ms << setw(11) << s.decode_us << setw(10) << s.score_us << setw(11) << s.engine_us << setw(10) << s.evaluate_us
+             << setw(13) << s.validate_ms << defaultfloat << endl;
+        points.push_back(s);
+    }
+
+    if (points.size() > 1) {
+        cout << "\nGrowth exponent against lectures (1 = linear):\n" << setw(8) << "courses";
+        for (int c = 0; c < COLUMNS; c++) cout << setw(10) << COLUMN_NAMES[c];
+        cout << endl;
+        for (size_t k = 1; k < points.size(); k++) {
+            double size = log(double(points[k].events) / points[k - 1].events);
+            cout << setw(8) << points[k].courses;
+            for (int c = 0; c < COLUMNS; c++) {
+                double exponent = log(column(points[k], c) / column(points[k - 1], c)) / size;
+                cout << setw(9) << fixed << setprecision(2) << exponent << (exponent > 1.2 ? '*' : ' ') << defaultfloat;
+            }
+            cout << endl;
+        }
+    }
+
+    if (!csv_file.empty()) {
+        ofstream os(csv_file.c_str());
+        os << "courses,rooms,curricula,lectures,conflict_edges,load_ms,decode_us,score_us,engine_us,evaluate_us,validate_ms\n";
+        for (const auto& s : points)
+            os << s.courses << ',' << s.rooms << ',' << s.curricula << ',' << s.events << ',' << s.conflict_edges << ',' << s.load_ms << ','
+               << s.decode_us << ',' << s.score_us << ',' << s.engine_us << ',' << s.evaluate_us << ',' << s.validate_ms << '\n';
+    }
+    return 0;
+}
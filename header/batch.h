@@ -0,0 +1,155 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "ga.h"
+#include "timetable.h"
+#include "validator.h"
+
+using namespace std;
+
+// One run of the batch solver: an instance solved with one seed
+struct BatchJob {
+    string instance;
+    unsigned seed;
+    string solution_file;
+    // filled in by run_batch()
+    int fitness = 0;
+    unsigned validated_cost = 0, violations = 0;
+    double seconds = 0;
+    unsigned long evaluations = 0;
+    bool done = false;
+};
+
+// Jobs of a job file: one instance per line followed by its seeds; an instance
+// without seeds gets seeds first_seed .. first_seed + seeds - 1. Empty lines and
+// lines starting with '#' are skipped. Solutions go to
+// solution_dir/<instance name>_s<seed>.out; jobs that would share that name (same
+// file name in different directories, or a repeated seed) get _j<job number>
+// appended, so no two jobs ever write the same file.
+inline bool read_jobs(const string& file_name, unsigned first_seed, unsigned seeds, const string& solution_dir, vector<BatchJob>& jobs) {
+    ifstream is(file_name.c_str());
+    string line;
+    if (!is) return false;
+    while (getline(is, line)) {
+        istringstream fields(line);
+        string instance;
+        vector<unsigned> instance_seeds;
+        unsigned seed;
+        if (!(fields >> instance) || instance[0] == '#') continue;
+        while (fields >> seed) instance_seeds.push_back(seed);
+        if (instance_seeds.empty())
+            for (unsigned k = 0; k < seeds; k++) instance_seeds.push_back(first_seed + k);
+        string stem = filesystem::path(instance).stem().string();
+        for (unsigned s : instance_seeds)
+            jobs.push_back({instance, s, solution_dir + "/" + stem + "_s" + to_string(s)});
+    }
+
+    map<string, unsigned> uses;
+    for (const auto& job : jobs) uses[job.solution_file]++;
+    for (size_t j = 0; j < jobs.size(); j++) {
+        if (uses[jobs[j].solution_file] > 1) jobs[j].solution_file += "_j" + to_string(j);
+        jobs[j].solution_file += ".out";
+    }
+    return true;
+}
+
+// Solve every job with params (seed and solution file taken from the job), running
+// slots jobs at a time; each job uses params.threads threads (or params.islands
+// islands) and stops at params.time_limit. Every instance is loaded once and
+// shared by its jobs. Jobs start largest instance first, so the long ones do not
+// end up alone at the end of the batch. Each finished job is reported on progress.
+// Returns false if some job could not write its solution.
+inline bool run_batch(vector<BatchJob>& jobs, const GAParameters& params, unsigned slots, ostream* progress = nullptr) {
+    map<string, unique_ptr<Faculty> > instances;
+    vector<const Faculty*> job_faculty(jobs.size()); // resolved here, so the pool threads never touch the map
+    for (size_t j = 0; j < jobs.size(); j++) {
+        unique_ptr<Faculty>& instance = instances[jobs[j].instance];
+        if (!instance) instance.reset(new Faculty(jobs[j].instance));
+        job_faculty[j] = instance.get();
+    }
+
+    vector<size_t> order(jobs.size());
+    iota(order.begin(), order.end(), 0);
+    stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return job_faculty[a]->Events() > job_faculty[b]->Events(); });
+
+    atomic<size_t> next(0);
+    mutex progress_mutex;
+    ThreadPool pool(max(1u, min<unsigned>(slots, jobs.size())));
+    pool.Run([&](unsigned) {
+        for (size_t k; (k = next.fetch_add(1)) < order.size();) {
+            BatchJob& job = jobs[order[k]];
+            const Faculty& faculty = *job_faculty[order[k]];
+            GAParameters p = params;
+            RunStats stats;
+            p.seed = job.seed;
+            p.solution_file = job.solution_file;
+
+            Population population = p.islands > 1 ? run_islands(faculty, p, stats) : run_ga(faculty, p, stats);
+            job.fitness = population[0].fitness;
+            job.seconds = stats.seconds;
+            job.evaluations = stats.evaluations;
+            job.done = write_solution(population[0], faculty, job.solution_file);
+            if (!job.done) {
+                lock_guard<mutex> lock(progress_mutex);
+                cerr << "Failed to write " << job.solution_file << endl;
+            } else {
+                Timetable timetable(faculty, job.solution_file);
+                Validator validator(faculty, timetable);
+                job.validated_cost = validator.TotalCost();
+                job.violations = validator.TotalViolations();
+            }
+
+            if (progress) {
+                lock_guard<mutex> lock(progress_mutex);
+                *progress << "[" << k + 1 << "/" << jobs.size() << "] " << job.instance << " seed " << job.seed << ": fitness "
+                          << job.fitness << (job.done ? "" : " (solution not written)") << endl;
+            }
+        }
+    });
+    return all_of(jobs.begin(), jobs.end(), [](const BatchJob& job) { return job.done; });
+}
+
+// Summary of a finished batch: one line per job and the best and mean cost of
+// every instance, as a table, or as CSV (job lines only)
+inline void write_batch_summary(ostream& os, const vector<BatchJob>& jobs, bool csv) {
+    if (csv) {
+        os << "instance,seed,solution,fitness,validated_cost,violations,seconds,evaluations\n";
+        for (const auto& j : jobs)
+            os << j.instance << ',' << j.seed << ',' << j.solution_file << ',' << j.fitness << ',' << j.validated_cost << ','
+               << j.violations << ',' << j.seconds << ',' << j.evaluations << '\n';
+        return;
+    }
+
+    os << left << setw(24) << "instance" << right << setw(8) << "seed" << setw(10) << "fitness" << setw(10) << "cost"
+       << setw(8) << "viol" << setw(10) << "seconds" << endl;
+    for (const auto& j : jobs)
+        os << left << setw(24) << j.instance << right << setw(8) << j.seed << setw(10) << j.fitness << setw(10) << j.validated_cost
+           << setw(8) << j.violations << setw(10) << fixed << setprecision(2) << j.seconds << defaultfloat << endl;
+
+    map<string, vector<const BatchJob*> > by_instance;
+    for (const auto& j : jobs) by_instance[j.instance].push_back(&j);
+    os << "\n" << left << setw(24) << "instance" << right << setw(8) << "runs" << setw(10) << "best" << setw(10) << "mean" << endl;
+    for (const auto& entry : by_instance) {
+        unsigned best = UINT_MAX;
+        double sum = 0;
+        for (const BatchJob* j : entry.second) {
+            best = min(best, j->validated_cost);
+            sum += j->validated_cost;
+        }
+        os << left << setw(24) << entry.first << right << setw(8) << entry.second.size() << setw(10) << best << setw(10) << fixed
+           << setprecision(1) << sum / entry.second.size() << defaultfloat << endl;
+    }
+}
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef BATCH_SCORER_H
+#define BATCH_SCORER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "faculty.h"
+#include "cost_kernels.h"
+
+using namespace std;
+
+// Soft cost of a complete timetable, the same as CostEngine::Cost() after
+// assigning every lecture, but computed in one pass: lectures only set bits in
+// per-curriculum and per-course period sets and per-course room sets, and
+// compactness and working days are then counted by the bitmask kernels over all
+// curricula and courses at once. A course must not have two lectures in one period.
+class BatchScorer {
+    private:
+        const Faculty& in;
+        DayLayout layout;
+        unsigned words, room_words;
+        vector<uint64_t> curriculum_periods; // (curricula X words)
+        vector<uint64_t> course_periods;     // (courses X words)
+        vector<uint64_t> course_rooms;       // (courses X room_words), bit r for room r
+        vector<unsigned> extra;              // curriculum * Periods() + period of each lecture beyond the first in a cell
+
+    public:
+        BatchScorer(const Faculty& f) : in(f), layout(f.PeriodsPerDay(), f.Days()), words(layout.Words()), room_words(f.Rooms() / 64 + 1),
+            curriculum_periods(f.Curricula() * words), course_periods(f.Courses() * words), course_rooms(f.Courses() * room_words) {}
+
+        // False if the instance has more than 64 periods per day
+        bool Supported() const { return layout.Supported(); }
+
+        template <typename Assignments>
+        int Score(const Assignments& assignments) {
+            unsigned room_capacity = 0, room_stability = 0, compactness, c;
+            fill(curriculum_periods.begin(), curriculum_periods.end(), 0);
+            fill(course_periods.begin(), course_periods.end(), 0);
+            fill(course_rooms.begin(), course_rooms.end(), 0);
+            extra.clear();
+
+            for (const auto& a : assignments) {
+                unsigned course = a.course_id, p = a.timeslot, r = a.room_id, w = layout.Word(p);
+                uint64_t bit = layout.Bit(p);
+                if (in.Students(course) > in.Capacity(r)) room_capacity += in.Students(course) - in.Capacity(r);
+                course_periods[course * words + w] |= bit;
+                course_rooms[course * room_words + r / 64] |= uint64_t(1) << (r % 64);
+                for (const unsigned* g = in.CourseCurriculaBegin(course); g != in.CourseCurriculaEnd(course); ++g) {
+                    uint64_t& periods = curriculum_periods[*g * words + w];
+                    if (periods & bit) extra.push_back(*g * in.Periods() + p);
+                    periods |= bit;
+                }
+            }
+
+            compactness = count_isolated(curriculum_periods.data(), curriculum_periods.size(), layout);
+            for (unsigned cell : extra) {
+                unsigned g = cell / in.Periods(), p = cell % in.Periods(), w = layout.Word(p);
+                if (isolated_periods(curriculum_periods[g * words + w], layout.First(), layout.Last()) & layout.Bit(p)) compactness++;
+            }
+            for (c = 0; c < in.Courses(); c++) {
+                unsigned rooms = 0;
+                for (unsigned w = 0; w < room_words; w++) rooms += __builtin_popcountll(course_rooms[c * room_words + w]);
+                if (rooms > 1) room_stability += rooms - 1;
+            }
+
+            return room_capacity + missing_working_days(course_periods.data(), in.MinWorkingDaysArray(), in.Courses(), layout) * in.MIN_WORKING_DAYS_COST
+                + compactness * in.CURRICULUM_COMPACTNESS_COST + room_stability * in.ROOM_STABILITY_COST;
+        }
+};
+
+#endif
@@ -0,0 +1,275 @@
+#ifndef COST_ENGINE_H
+#define COST_ENGINE_H
+
+#include <cstdint>
+#include <vector>
+#include "faculty.h"
+
+using namespace std;
+
+// Stateful evaluator of a (courses X periods) timetable. It keeps the same
+// redundant counters as Timetable, but updates them one lecture at a time, so
+// the cost of a move depends only on the moved courses (their curricula and the
+// smaller of their conflict list and conflict row) instead of rescoring the
+// whole timetable. Costs follow Validator exactly.
+class CostEngine {
+    private:
+        struct Change {
+            unsigned course, period, room;
+            bool assigned;
+        };
+
+        const Faculty& in;
+        vector<vector<unsigned> > tt; // (courses X periods) room of each lecture, 0 = not scheduled
+        // redundant data
+        vector<vector<unsigned> > room_lectures; // (rooms X periods) number of lectures per room in the same period
+        vector<vector<unsigned> > curriculum_period_lectures; // (curricula X periods)
+        vector<vector<unsigned> > course_daily_lectures; // (courses X days)
+        vector<vector<unsigned> > course_room_lectures; // (courses X rooms) lectures of a course in each room
+        vector<vector<unsigned> > period_courses; // courses scheduled in each period
+        vector<vector<unsigned> > period_position; // (courses X periods) index of the course in period_courses[p]
+        vector<uint64_t> period_bits; // (periods X ConflictWords()) courses scheduled in each period
+        vector<unsigned> scheduled_lectures, working_days, used_rooms;
+        unsigned empty_lectures, empty_min_working_days; // hard and soft counts of the empty timetable
+
+        // hard violations
+        unsigned lectures, conflicts, availability, room_occupation;
+        // soft costs (unweighted, as in Validator)
+        unsigned room_capacity, min_working_days, curriculum_compactness, room_stability;
+
+        vector<Change> journal;
+        bool recording;
+        int saved_cost, saved_violations;
+
+        unsigned IsolatedLectures(unsigned g, unsigned p) const {
+            unsigned ppd = in.PeriodsPerDay();
+            if (curriculum_period_lectures[g][p] == 0) return 0;
+            if (p % ppd != 0 && curriculum_period_lectures[g][p - 1] > 0) return 0;
+            if (p % ppd != ppd - 1 && curriculum_period_lectures[g][p + 1] > 0) return 0;
+            return curriculum_period_lectures[g][p];
+        }
+
+        // Isolated lectures of curriculum g in p and its neighbours on the same day
+        unsigned LocalCompactness(unsigned g, unsigned p) const {
+            unsigned ppd = in.PeriodsPerDay(), cost = IsolatedLectures(g, p);
+            if (p % ppd != 0) cost += IsolatedLectures(g, p - 1);
+            if (p % ppd != ppd - 1) cost += IsolatedLectures(g, p + 1);
+            return cost;
+        }
+
+        static unsigned Missing(unsigned required, unsigned actual) {
+            return actual < required ? required - actual : 0;
+        }
+
+        static unsigned Difference(unsigned a, unsigned b) {
+            return a > b ? a - b : b - a;
+        }
+
+        // Courses in period p that conflict with c: through c's conflict list or
+        // its conflict row, whichever is shorter
+        unsigned PeriodConflicts(unsigned c, unsigned p) const {
+            unsigned words = in.ConflictWords(), n = 0, w;
+            const uint64_t* courses = period_bits.data() + size_t(p) * words;
+            if (in.ConflictDegree(c) < words) {
+                for (const unsigned* c2 = in.ConflictsBegin(c); c2 != in.ConflictsEnd(c); ++c2)
+                    n += courses[*c2 / 64] >> (*c2 % 64) & 1;
+                return n;
+            }
+            const uint64_t* row = in.ConflictBits(c);
+            for (w = 0; w < words; w++)
+                n += __builtin_popcountll(row[w] & courses[w]);
+            return n;
+        }
+
+        void Update(unsigned c, unsigned p, unsigned r, bool assign) {
+            unsigned d = p / in.PeriodsPerDay(), i;
+            const unsigned* g;
+
+            lectures -= Difference(in.Lectures(c), scheduled_lectures[c]);
+            min_working_days -= Missing(in.MinWorkingDays(c), working_days[c]);
+            if (used_rooms[c] > 1) room_stability -= used_rooms[c] - 1;
+            if (room_lectures[r][p] > 1) room_occupation -= room_lectures[r][p] - 1;
+            for (g = in.CourseCurriculaBegin(c); g != in.CourseCurriculaEnd(c); ++g)
+                curriculum_compactness -= LocalCompactness(*g, p);
+
+            uint64_t& bit_word = period_bits[size_t(p) * in.ConflictWords() + c / 64];
+            if (assign) {
+                conflicts += PeriodConflicts(c, p);
+                period_position[c][p] = period_courses[p].size();
+                period_courses[p].push_back(c);
+                bit_word |= uint64_t(1) << (c % 64);
+                if (!in.Available(c, p)) availability++;
+                if (in.Students(c) > in.Capacity(r))
+                    room_capacity += in.Students(c) - in.Capacity(r);
+
+                tt[c][p] = r;
+                scheduled_lectures[c]++;
+                room_lectures[r][p]++;
+                if (course_daily_lectures[c][d]++ == 0) working_days[c]++;
+                if (course_room_lectures[c][r]++ == 0) used_rooms[c]++;
+                for (g = in.CourseCurriculaBegin(c); g != in.CourseCurriculaEnd(c); ++g)
+                    curriculum_period_lectures[*g][p]++;
+            } else {
+                i = period_position[c][p];
+                period_courses[p][i] = period_courses[p].back();
+                period_position[period_courses[p][i]][p] = i;
+                period_courses[p].pop_back();
+                bit_word &= ~(uint64_t(1) << (c % 64));
+                conflicts -= PeriodConflicts(c, p);
+                if (!in.Available(c, p)) availability--;
+                if (in.Students(c) > in.Capacity(r))
+                    room_capacity -= in.Students(c) - in.Capacity(r);
+
+                tt[c][p] = 0;
+                scheduled_lectures[c]--;
+                room_lectures[r][p]--;
+                if (--course_daily_lectures[c][d] == 0) working_days[c]--;
+                if (--course_room_lectures[c][r] == 0) used_rooms[c]--;
+                for (g = in.CourseCurriculaBegin(c); g != in.CourseCurriculaEnd(c); ++g)
+                    curriculum_period_lectures[*g][p]--;
+            }
+
+            lectures += Difference(in.Lectures(c), scheduled_lectures[c]);
+            min_working_days += Missing(in.MinWorkingDays(c), working_days[c]);
+            if (used_rooms[c] > 1) room_stability += used_rooms[c] - 1;
+            if (room_lectures[r][p] > 1) room_occupation += room_lectures[r][p] - 1;
+            for (g = in.CourseCurriculaBegin(c); g != in.CourseCurriculaEnd(c); ++g)
+                curriculum_compactness += LocalCompactness(*g, p);
+
+            if (recording) journal.push_back({c, p, r, assign});
+        }
+
+    public:
+        CostEngine(const Faculty& f) : in(f), tt(in.Courses(), vector<unsigned>(in.Periods(), 0)),
+            room_lectures(in.Rooms() + 1, vector<unsigned>(in.Periods(), 0)),
+            curriculum_period_lectures(in.Curricula(), vector<unsigned>(in.Periods(), 0)),
+            course_daily_lectures(in.Courses(), vector<unsigned>(in.Days(), 0)),
+            course_room_lectures(in.Courses(), vector<unsigned>(in.Rooms() + 1, 0)),
+            period_courses(in.Periods()), period_position(in.Courses(), vector<unsigned>(in.Periods(), 0)),
+            period_bits(size_t(in.Periods()) * in.ConflictWords(), 0), scheduled_lectures(in.Courses(), 0),
+            working_days(in.Courses(), 0), used_rooms(in.Courses(), 0), recording(false) {
+            unsigned c;
+            empty_lectures = empty_min_working_days = 0;
+            for (c = 0; c < in.Courses(); c++) {
+                empty_lectures += in.Lectures(c);
+                empty_min_working_days += in.MinWorkingDays(c);
+            }
+            lectures = empty_lectures;
+            min_working_days = empty_min_working_days;
+            conflicts = availability = room_occupation = 0;
+            room_capacity = curriculum_compactness = room_stability = 0;
+            saved_cost = saved_violations = 0;
+            // room for the lectures of a period and the changes of a Kempe chain move without reallocating
+            for (unsigned p = 0; p < in.Periods(); p++) period_courses[p].reserve(in.Rooms());
+            journal.reserve(4 * in.Rooms());
+        }
+
+        // Inspect timetable
+        unsigned operator()(unsigned c, unsigned p) const { return tt[c][p]; }
+        unsigned PeriodCoursesNo(unsigned p) const { return period_courses[p].size(); }
+        unsigned PeriodCourses(unsigned p, unsigned i) const { return period_courses[p][i]; }
+        unsigned RoomLectures(unsigned r, unsigned p) const { return room_lectures[r][p]; }
+
+        // Schedule a lecture of course c in period p and room r (tt[c][p] must be free)
+        void Assign(unsigned c, unsigned p, unsigned r) { Update(c, p, r, true); }
+        // Remove the lecture of course c in period p (tt[c][p] must be scheduled)
+        void Unassign(unsigned c, unsigned p) { Update(c, p, tt[c][p], false); }
+
+        // Remove every lecture, in O(periods + scheduled lectures x their curricula):
+        // the counters touched by the scheduled lectures are zeroed directly and the
+        // costs reset to those of the empty timetable
+        void Clear() {
+            unsigned ppd = in.PeriodsPerDay(), words = in.ConflictWords(), p, r;
+            const unsigned* g;
+            for (p = 0; p < in.Periods(); p++) {
+                for (unsigned c : period_courses[p]) {
+                    r = tt[c][p];
+                    tt[c][p] = 0;
+                    room_lectures[r][p] = 0;
+                    course_daily_lectures[c][p / ppd] = 0;
+                    course_room_lectures[c][r] = 0;
+                    scheduled_lectures[c] = working_days[c] = used_rooms[c] = 0;
+                    period_bits[size_t(p) * words + c / 64] = 0;
+                    for (g = in.CourseCurriculaBegin(c); g != in.CourseCurriculaEnd(c); ++g)
+                        curriculum_period_lectures[*g][p] = 0;
+                }
+                period_courses[p].clear();
+            }
+            lectures = empty_lectures;
+            min_working_days = empty_min_working_days;
+            conflicts = availability = room_occupation = 0;
+            room_capacity = curriculum_compactness = room_stability = 0;
+            journal.clear();
+        }
+
+        unsigned Violations() const { return lectures + conflicts + availability + room_occupation; }
+        int Cost() const {
+            return room_capacity + min_working_days * in.MIN_WORKING_DAYS_COST
+                + curriculum_compactness * in.CURRICULUM_COMPACTNESS_COST + room_stability * in.ROOM_STABILITY_COST;
+        }
+
+        unsigned CostsOnLectures() const { return lectures; }
+        unsigned CostsOnConflicts() const { return conflicts; }
+        unsigned CostsOnAvailability() const { return availability; }
+        unsigned CostsOnRoomOccupation() const { return room_occupation; }
+        unsigned CostsOnRoomCapacity() const { return room_capacity; }
+        unsigned CostsOnMinWorkingDays() const { return min_working_days; }
+        unsigned CostsOnCurriculumCompactness() const { return curriculum_compactness; }
+        unsigned CostsOnRoomStability() const { return room_stability; }
+
+        // Moves: open a move, apply its changes and return the change of Cost().
+        // The move stays pending until Commit() or Rollback().
+        void BeginMove() {
+            journal.clear();
+            recording = true;
+            saved_cost = Cost();
+            saved_violations = Violations();
+        }
+        int Delta() const { return Cost() - saved_cost; }
+        int ViolationsDelta() const { return static_cast<int>(Violations()) - saved_violations; }
+
+        int MoveLecture(unsigned c, unsigned from, unsigned to, unsigned r) {
+            BeginMove();
+            Unassign(c, from);
+            Assign(c, to, r);
+            return Delta();
+        }
+
+        // Exchange period and room of two lectures of different courses
+        int SwapLectures(unsigned c1, unsigned p1, unsigned c2, unsigned p2) {
+            unsigned r1 = tt[c1][p1], r2 = tt[c2][p2];
+            BeginMove();
+            Unassign(c1, p1);
+            Unassign(c2, p2);
+            Assign(c1, p2, r2);
+            Assign(c2, p1, r1);
+            return Delta();
+        }
+
+        // Exchange the rooms of two lectures in the same period
+        int SwapRooms(unsigned c1, unsigned c2, unsigned p) {
+            unsigned r1 = tt[c1][p], r2 = tt[c2][p];
+            BeginMove();
+            Unassign(c1, p);
+            Unassign(c2, p);
+            Assign(c1, p, r2);
+            Assign(c2, p, r1);
+            return Delta();
+        }
+
+        void Commit() {
+            recording = false;
+            journal.clear();
+        }
+
+        void Rollback() {
+            recording = false;
+            while (!journal.empty()) {
+                Change ch = journal.back();
+                journal.pop_back();
+                Update(ch.course, ch.period, ch.room, !ch.assigned);
+            }
+        }
+};
+
+#endif
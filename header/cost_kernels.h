@@ -0,0 +1,122 @@
+#ifndef COST_KERNELS_H
+#define COST_KERNELS_H
+
+#include <cstdint>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+// Bitmask kernels for the day-based soft costs. A set of periods is stored with
+// whole days packed into each 64-bit word: day d takes bits
+// (d % DaysPerWord()) * ppd .. + ppd - 1 of word d / DaysPerWord(). Every word
+// then has the same layout, so the same day masks apply to all of them and no
+// day straddles two words. Needs PeriodsPerDay() <= 64 (Supported()).
+class DayLayout {
+    private:
+        unsigned ppd, days_per_word, words;
+        uint64_t first, last, fill; // first and last period of every day, other periods of every day
+    public:
+        DayLayout(unsigned periods_per_day, unsigned days) : ppd(periods_per_day), days_per_word(0), words(0), first(0), last(0), fill(0) {
+            if (!Supported()) return;
+            days_per_word = 64 / ppd;
+            words = (days + days_per_word - 1) / days_per_word;
+            for (unsigned d = 0; d < days_per_word; d++) {
+                uint64_t day = (ppd == 64 ? ~uint64_t(0) : (uint64_t(1) << ppd) - 1) << (d * ppd);
+                first |= uint64_t(1) << (d * ppd);
+                last |= uint64_t(1) << (d * ppd + ppd - 1);
+                fill |= day;
+            }
+            fill &= ~last;
+        }
+
+        bool Supported() const { return ppd > 0 && ppd <= 64; }
+        unsigned Words() const { return words; } // words per set of periods
+        unsigned DaysPerWord() const { return days_per_word; }
+        uint64_t First() const { return first; }
+        uint64_t Last() const { return last; }
+        uint64_t Fill() const { return fill; }
+
+        unsigned Word(unsigned p) const { return p / ppd / days_per_word; }
+        uint64_t Bit(unsigned p) const { return uint64_t(1) << (p / ppd % days_per_word * ppd + p % ppd); }
+        // Period of bit b of word w
+        unsigned Period(unsigned w, unsigned b) const { return (w * days_per_word + b / ppd) * ppd + b % ppd; }
+};
+
+// Periods of m with no neighbour in m on the same day
+inline uint64_t isolated_periods(uint64_t m, uint64_t first, uint64_t last) {
+    return m & ~((m << 1) & ~first) & ~((m >> 1) & ~last);
+}
+
+// Last-period bit of every day with some period in m: adding fill to the other
+// periods of a day carries into its last bit exactly when one of them is set
+inline uint64_t busy_days(uint64_t m, uint64_t last, uint64_t fill) {
+    return (((m & ~last) + fill) | m) & last;
+}
+
+#ifdef __AVX2__
+// Population count of each 64-bit lane (nibble lookup)
+inline __m256i popcount_epi64(__m256i v) {
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i nibble = _mm256_set1_epi8(0x0f);
+    __m256i low = _mm256_shuffle_epi8(lookup, _mm256_and_si256(v, nibble));
+    __m256i high = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble));
+    return _mm256_sad_epu8(_mm256_add_epi8(low, high), _mm256_setzero_si256());
+}
+
+inline uint64_t horizontal_sum_epi64(__m256i v) {
+    __m128i s = _mm_add_epi64(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    return uint64_t(_mm_cvtsi128_si64(s)) + uint64_t(_mm_extract_epi64(s, 1));
+}
+#endif
+
+// Isolated periods in the n period sets masks[0 .. n) (any number of sets of
+// layout.Words() words each, back to back)
+inline unsigned count_isolated(const uint64_t* masks, size_t n, const DayLayout& layout) {
+    uint64_t first = layout.First(), last = layout.Last(), count = 0;
+    size_t i = 0;
+#ifdef __AVX2__
+    const __m256i vfirst = _mm256_set1_epi64x(first), vlast = _mm256_set1_epi64x(last);
+    __m256i total = _mm256_setzero_si256();
+    for (; i + 4 <= n; i += 4) {
+        __m256i m = _mm256_loadu_si256((const __m256i*)(masks + i));
+        __m256i left = _mm256_andnot_si256(vfirst, _mm256_slli_epi64(m, 1));
+        __m256i right = _mm256_andnot_si256(vlast, _mm256_srli_epi64(m, 1));
+        total = _mm256_add_epi64(total, popcount_epi64(_mm256_andnot_si256(left, _mm256_andnot_si256(right, m))));
+    }
+    count = horizontal_sum_epi64(total);
+#endif
+    for (; i < n; i++) count += __builtin_popcountll(isolated_periods(masks[i], first, last));
+    return count;
+}
+
+// Sum over courses c < n of the days missing to required[c], where course c
+// takes the period set masks[c * layout.Words() ..]
+inline unsigned missing_working_days(const uint64_t* masks, const unsigned* required, unsigned n, const DayLayout& layout) {
+    uint64_t last = layout.Last(), fill = layout.Fill(), missing = 0;
+    unsigned words = layout.Words(), c = 0, w;
+#ifdef __AVX2__
+    if (words == 1) {
+        const __m256i vlast = _mm256_set1_epi64x(last), vfill = _mm256_set1_epi64x(fill);
+        __m256i total = _mm256_setzero_si256();
+        for (; c + 4 <= n; c += 4) {
+            __m256i m = _mm256_loadu_si256((const __m256i*)(masks + c));
+            __m256i days = _mm256_and_si256(_mm256_or_si256(_mm256_add_epi64(_mm256_andnot_si256(vlast, m), vfill), m), vlast);
+            __m256i need = _mm256_cvtepu32_epi64(_mm_loadu_si128((const __m128i*)(required + c)));
+            __m256i gap = _mm256_sub_epi64(need, popcount_epi64(days));
+            total = _mm256_add_epi64(total, _mm256_and_si256(gap, _mm256_cmpgt_epi64(gap, _mm256_setzero_si256())));
+        }
+        missing = horizontal_sum_epi64(total);
+    }
+#endif
+    for (; c < n; c++) {
+        unsigned days = 0;
+        for (w = 0; w < words; w++) days += __builtin_popcountll(busy_days(masks[c * words + w], last, fill));
+        if (days < required[c]) missing += required[c] - days;
+    }
+    return missing;
+}
+
+#endif
@@ -13,6 +13,9 @@ class Course {
         string name, teacher;
         unsigned lectures, students, min_working_days;
     public:
+        Course() : lectures(0), students(0), min_working_days(0) {}
+        Course(const string& n, const string& t, unsigned l, unsigned mwd, unsigned s)
+            : name(n), teacher(t), lectures(l), students(s), min_working_days(mwd) {}
         const string& Name() const { return name; }
         const string& Teacher() const { return teacher; }
         unsigned Lectures() const { return lectures; }
@@ -0,0 +1,15 @@
+#ifndef EVENT_H
+#define EVENT_H
+
+using namespace std;
+
+// A single lecture of a course. Events are numbered course by course, so the
+// lectures of course c are the events CourseFirstEvent(c) .. CourseFirstEvent(c + 1) - 1
+struct Event {
+    unsigned course;   // index of the course in Faculty
+    unsigned lecture;  // index of the lecture within its course
+    unsigned students; // copy of the course size, to avoid touching Course in hot loops
+    unsigned curricula_start, curricula_end; // span of the course in Faculty's course-curricula index
+};
+
+#endif
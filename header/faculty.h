@@ -1,12 +1,19 @@
 #ifndef FACULTY_H
 #define FACULTY_H
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 #include "course.h"
 #include "room.h"
 #include "curriculum.h"
+#include "event.h"
+#include "mapped_file.h"
 
 using namespace std;
 
@@ -15,12 +22,40 @@ class Faculty {
         string name;
         unsigned courses, rooms, curricula, periods, periods_per_day;
 
+        // parsed records; their names are only used for I/O
         vector<Course> course_vect;
         vector<Room> room_vect;
         vector<Curriculum> curricula_vect;
 
-        vector<vector<bool> > availability;
-        vector<vector<bool> > conflict;
+        // the numeric fields of the records as contiguous arrays, for the hot paths;
+        // room_capacity is indexed by room (entry 0 unused) and rooms_by_capacity
+        // lists rooms 1 .. rooms by increasing capacity, then index
+        vector<unsigned> course_lectures, course_students, course_min_working_days;
+        vector<unsigned> room_capacity, rooms_by_capacity;
+
+        // name -> index, built once at load time; keys are views into the names above
+        unordered_map<string_view, unsigned> course_index, room_index, curriculum_index;
+
+        unsigned period_words;
+        vector<uint64_t> availability_bits; // (courses X period_words) bit p set if course is available in period p
+
+        // conflict graph: two courses conflict if they share a curriculum or a teacher.
+        // conflict_bits is the (courses X conflict_words) adjacency matrix, one bit per
+        // course; the neighbours of course c, in increasing order, are
+        // conflict_adjacency[conflict_start[c] .. conflict_start[c + 1])
+        unsigned conflict_words;
+        vector<uint64_t> conflict_bits;
+        vector<unsigned> conflict_start;
+        vector<unsigned> conflict_adjacency;
+        unsigned max_conflict_degree;
+
+        // curricula of each course, in CSR layout: the curricula of course c are
+        // course_curricula[course_curricula_start[c] .. course_curricula_start[c + 1])
+        vector<unsigned> course_curricula_start;
+        vector<unsigned> course_curricula;
+
+        vector<Event> event_vect;
+        vector<unsigned> course_first_event;
     public:
         unsigned Courses() const { return courses; }
         unsigned Rooms() const { return rooms; }
@@ -28,12 +63,37 @@ class Faculty {
         unsigned Periods() const { return periods; }
         unsigned PeriodsPerDay() const { return periods_per_day; }
         unsigned Days() const { return periods / periods_per_day; }
+        unsigned Events() const { return event_vect.size(); }
 
-        bool Available(unsigned c, unsigned p) const { return availability[c][p]; }
-        bool Conflict(unsigned c1, unsigned c2) const { return conflict[c1][c2]; }
+        bool Available(unsigned c, unsigned p) const { return availability_bits[c * period_words + p / 64] >> (p % 64) & 1; }
+        unsigned PeriodWords() const { return period_words; }
+        const uint64_t* AvailabilityBits(unsigned c) const { return availability_bits.data() + c * period_words; }
+        bool Conflict(unsigned c1, unsigned c2) const { return conflict_bits[c1 * conflict_words + c2 / 64] >> (c2 % 64) & 1; }
+        unsigned ConflictWords() const { return conflict_words; }
+        const uint64_t* ConflictBits(unsigned c) const { return conflict_bits.data() + c * conflict_words; }
+        unsigned ConflictDegree(unsigned c) const { return conflict_start[c + 1] - conflict_start[c]; }
+        const unsigned* ConflictsBegin(unsigned c) const { return conflict_adjacency.data() + conflict_start[c]; }
+        const unsigned* ConflictsEnd(unsigned c) const { return conflict_adjacency.data() + conflict_start[c + 1]; }
+        unsigned ConflictEdges() const { return conflict_adjacency.size() / 2; }
+        unsigned MaxConflictDegree() const { return max_conflict_degree; }
+        double AverageConflictDegree() const { return courses == 0 ? 0.0 : double(conflict_adjacency.size()) / courses; }
+        unsigned Lectures(unsigned c) const { return course_lectures[c]; }
+        unsigned Students(unsigned c) const { return course_students[c]; }
+        unsigned MinWorkingDays(unsigned c) const { return course_min_working_days[c]; }
+        const unsigned* MinWorkingDaysArray() const { return course_min_working_days.data(); }
+        unsigned Capacity(unsigned r) const { return room_capacity[r]; }
+        const unsigned* RoomsByCapacity() const { return rooms_by_capacity.data(); }
         const Course& CourseVector(int i) const { return course_vect[i]; }
         const Room& RoomVector(int i) const { return room_vect[i]; }    
         const Curriculum& CurriculaVector(int i) const { return curricula_vect[i]; }
+        unsigned CourseCurriculaNo(unsigned c) const { return course_curricula_start[c + 1] - course_curricula_start[c]; }
+        unsigned CourseCurricula(unsigned c, unsigned i) const { return course_curricula[course_curricula_start[c] + i]; }
+        const unsigned* CourseCurriculaBegin(unsigned c) const { return course_curricula.data() + course_curricula_start[c]; }
+        const unsigned* CourseCurriculaEnd(unsigned c) const { return course_curricula.data() + course_curricula_start[c + 1]; }
+        const Event& EventVector(unsigned e) const { return event_vect[e]; }
+        unsigned CourseFirstEvent(unsigned c) const { return course_first_event[c]; }
+        const unsigned* EventCurriculaBegin(unsigned e) const { return course_curricula.data() + event_vect[e].curricula_start; }
+        const unsigned* EventCurriculaEnd(unsigned e) const { return course_curricula.data() + event_vect[e].curricula_end; }
 
         int PeriodIndex(const string&) const;
         const string& Name() const { return name; }
@@ -42,102 +102,376 @@ class Faculty {
         const unsigned CURRICULUM_COMPACTNESS_COST;
         const unsigned ROOM_STABILITY_COST;
 
-    public:
-        Faculty(const string& file_name) : MIN_WORKING_DAYS_COST(5), CURRICULUM_COMPACTNESS_COST(2), ROOM_STABILITY_COST(1) {
-            string curriculum, course_name, room_name, period_name, teacher_name, priority, buffer;
-            string course_name1, course_name2;
-            unsigned curriculum_size, days, constraints, i;
-            ifstream is(file_name.c_str());
+        static constexpr char BINARY_MAGIC[9] = "TRJINST1";
 
-            if (is.fail()) {
-                cerr << "Input file does not exist!" << endl;
-                exit(1);
-            }
+    private:
+        void IndexCourses() {
+            course_index.clear();
+            course_index.reserve(courses);
+            for (unsigned i = 0; i < courses; i++) { course_index.emplace(course_vect[i].Name(), i); }
+        }
 
-            is >> buffer >> name;
-            is >> buffer >> courses;
-            is >> buffer >> rooms;
-            is >> buffer >> days;
-            is >> buffer >> periods_per_day;
-            is >> buffer >> curricula;
-            is >> buffer >> constraints;
+        void IndexRooms() {
+            room_index.clear();
+            room_index.reserve(rooms);
+            for (unsigned i = 1; i <= rooms; i++) { room_index.emplace(room_vect[i].Name(), i); }
+        }
 
-            periods = days * periods_per_day;
+        void IndexCurricula() {
+            curriculum_index.clear();
+            curriculum_index.reserve(curricula);
+            for (unsigned i = 0; i < curricula; i++) { curriculum_index.emplace(curricula_vect[i].Name(), i); }
+        }
 
+        void Resize() {
             course_vect.resize(courses);
             room_vect.resize(rooms + 1); // location 0 of room_vect is not used (teaching in room 0 means NOT TEACHING)
             curricula_vect.resize(curricula);
-            availability.resize(courses, vector<bool> (periods, true));
-            conflict.resize(courses, vector<bool> (courses));
+            period_words = (periods + 63) / 64;
+            availability_bits.assign(courses * period_words, 0);
+            conflict_words = (courses + 63) / 64;
+            conflict_bits.assign(courses * conflict_words, 0);
+        }
+
+        void SetConflict(unsigned c1, unsigned c2) {
+            if (c1 == c2) return;
+            conflict_bits[c1 * conflict_words + c2 / 64] |= uint64_t(1) << (c2 % 64);
+            conflict_bits[c2 * conflict_words + c1 / 64] |= uint64_t(1) << (c1 % 64);
+        }
+
+        // Arrays of the numeric course and room fields, from the records
+        void CompileRecords() {
+            unsigned i;
+            course_lectures.resize(courses);
+            course_students.resize(courses);
+            course_min_working_days.resize(courses);
+            for (i = 0; i < courses; i++) {
+                course_lectures[i] = course_vect[i].Lectures();
+                course_students[i] = course_vect[i].Students();
+                course_min_working_days[i] = course_vect[i].MinWorkingDays();
+            }
+            room_capacity.assign(rooms + 1, 0);
+            rooms_by_capacity.resize(rooms);
+            for (i = 1; i <= rooms; i++) {
+                room_capacity[i] = room_vect[i].Capacity();
+                rooms_by_capacity[i - 1] = i;
+            }
+            stable_sort(rooms_by_capacity.begin(), rooms_by_capacity.end(),
+                        [this](unsigned r1, unsigned r2) { return room_capacity[r1] < room_capacity[r2]; });
+        }
+
+        // Adjacency lists and degrees from the conflict bits, in O(courses * conflict_words + edges)
+        void BuildConflictGraph() {
+            unsigned c, w;
+            conflict_start.assign(courses + 1, 0);
+            conflict_adjacency.clear();
+            max_conflict_degree = 0;
+            for (c = 0; c < courses; c++) {
+                const uint64_t* row = ConflictBits(c);
+                for (w = 0; w < conflict_words; w++)
+                    for (uint64_t bits = row[w]; bits; bits &= bits - 1)
+                        conflict_adjacency.push_back(w * 64 + __builtin_ctzll(bits));
+                conflict_start[c + 1] = conflict_adjacency.size();
+                max_conflict_degree = max(max_conflict_degree, ConflictDegree(c));
+            }
+        }
+
+        // Parse the ITC-2007 text format in place, without allocating per token;
+        // returns false, after saying why, if a curriculum or constraint names an
+        // unknown course or a constraint names a nonexisting day or period
+        bool ReadText(const MappedFile& file) {
+            Tokenizer is(file.Data(), file.Size());
+            unsigned curriculum_size, days, constraints, i;
+
+            is.Skip(); name = string(is.Next());
+            is.Skip(); courses = is.NextUnsigned();
+            is.Skip(); rooms = is.NextUnsigned();
+            is.Skip(); days = is.NextUnsigned();
+            is.Skip(); periods_per_day = is.NextUnsigned();
+            is.Skip(); curricula = is.NextUnsigned();
+            is.Skip(); constraints = is.NextUnsigned();
+
+            periods = days * periods_per_day;
+            if (periods == 0) {
+                cerr << "No periods in the instance" << endl;
+                return false;
+            }
+            Resize();
 
-            is >> buffer;
-            for (i = 0; i < courses; i++) { is >> course_vect[i]; }
+            is.Skip();
+            for (i = 0; i < courses; i++) {
+                string_view course_name = is.Next(), teacher_name = is.Next();
+                unsigned lectures = is.NextUnsigned(), min_working_days = is.NextUnsigned(), students = is.NextUnsigned();
+                course_vect[i] = Course(string(course_name), string(teacher_name), lectures, min_working_days, students);
+            }
+            IndexCourses();
 
-            is >> buffer;
-            for (i = 1; i <= rooms; i++) { is >> room_vect[i]; }
+            is.Skip();
+            for (i = 1; i <= rooms; i++) {
+                string_view room_name = is.Next();
+                room_vect[i] = Room(string(room_name), is.NextUnsigned());
+            }
+            IndexRooms();
 
-            is >> buffer;
+            is.Skip();
             for (i = 0; i < curricula; i++) {
-                is >> buffer >> curriculum_size;
-                curricula_vect[i].SetName(buffer);
+                curricula_vect[i].SetName(string(is.Next()));
+                curriculum_size = is.NextUnsigned();
                 unsigned i1, i2;
                 for (i1 = 0; i1 < curriculum_size; i1++) {
                     int c1; unsigned c2;
-                    is >> course_name;
+                    string_view course_name = is.Next();
                     c1 = CourseIndex(course_name);
+                    if (c1 == -1) {
+                        cerr << "Unknown course " << course_name << " in curriculum " << curricula_vect[i].Name() << endl;
+                        return false;
+                    }
                     curricula_vect[i].AddMember(c1);
                     for (i2 = 0; i2 < i1; i2++) {
                         c2 = curricula_vect[i][i2];
-                        conflict[c1][c2] = true;
-                        conflict[c2][c1] = true;
+                        SetConflict(c1, c2);
                     }
                 }
             }
+            IndexCurricula();
 
-            is >> buffer;
+            for (unsigned c1 = 0; c1 < courses; c1++)
+                for (unsigned p1 = 0; p1 < periods; p1++)
+                    availability_bits[c1 * period_words + p1 / 64] |= uint64_t(1) << (p1 % 64);
+
+            is.Skip();
             int c, p, period_index, day_index;
 
             for (i = 0; i < constraints; i++) {
-                is >> course_name >> day_index >> period_index;
-                p = day_index * periods_per_day + period_index;
+                string_view course_name = is.Next();
                 c = CourseIndex(course_name);
-                availability[c][p] = false;
+                day_index = is.NextUnsigned();
+                period_index = is.NextUnsigned();
+                if (c == -1) {
+                    cerr << "Unknown course " << course_name << " in an unavailability constraint" << endl;
+                    return false;
+                }
+                if (unsigned(day_index) >= days || unsigned(period_index) >= periods_per_day) {
+                    cerr << "Nonexisting period " << day_index << " " << period_index << " in a constraint of course " << course_name << endl;
+                    return false;
+                }
+                p = day_index * periods_per_day + period_index;
+                availability_bits[c * period_words + p / 64] &= ~(uint64_t(1) << (p % 64));
             }
 
-            for (unsigned c1 = 0; c1 < courses - 1; c1++) {
-                for (unsigned c2 = c1 + 1; c2 < courses; c2++) {
-                    if (course_vect[c1].Teacher() == course_vect[c2].Teacher()) {
-                        conflict[c1][c2] = true;
-                        conflict[c2][c1] = true;
-                    }
+            // courses of the same teacher, grouped by hashing instead of comparing all pairs
+            unordered_map<string_view, vector<unsigned> > teacher_courses;
+            for (unsigned c1 = 0; c1 < courses; c1++) {
+                vector<unsigned>& same_teacher = teacher_courses[course_vect[c1].Teacher()];
+                for (unsigned c2 : same_teacher)
+                    SetConflict(c1, c2);
+                same_teacher.push_back(c1);
+            }
+            BuildConflictGraph();
+
+            course_curricula_start.assign(courses + 1, 0);
+            for (i = 0; i < curricula; i++)
+                for (unsigned j = 0; j < curricula_vect[i].Size(); j++)
+                    course_curricula_start[curricula_vect[i][j] + 1]++;
+            for (i = 0; i < courses; i++)
+                course_curricula_start[i + 1] += course_curricula_start[i];
+            course_curricula.resize(course_curricula_start[courses]);
+            vector<unsigned> fill(course_curricula_start.begin(), course_curricula_start.end() - 1);
+            for (i = 0; i < curricula; i++)
+                for (unsigned j = 0; j < curricula_vect[i].Size(); j++)
+                    course_curricula[fill[curricula_vect[i][j]]++] = i;
+
+            course_first_event.resize(courses + 1);
+            for (i = 0; i < courses; i++) {
+                course_first_event[i] = event_vect.size();
+                for (unsigned l = 0; l < course_vect[i].Lectures(); l++)
+                    event_vect.push_back({i, l, course_vect[i].Students(), course_curricula_start[i], course_curricula_start[i + 1]});
+            }
+            course_first_event[courses] = event_vect.size();
+            CompileRecords();
+            return true;
+        }
+
+        // True if the compiled tables read from a binary file only index what exists:
+        // no bits past the last period or course, monotone CSR starts that cover the
+        // arrays, and events that match their course's lectures and curricula span
+        bool ConsistentTables() const {
+            unsigned c, w, e;
+            uint64_t last_periods = periods % 64 == 0 ? ~uint64_t(0) : (uint64_t(1) << (periods % 64)) - 1;
+            uint64_t last_courses = courses % 64 == 0 ? ~uint64_t(0) : (uint64_t(1) << (courses % 64)) - 1;
+            if (course_curricula_start[0] != 0 || course_first_event[0] != 0 || course_first_event[courses] != event_vect.size())
+                return false;
+            for (c = 0; c < courses; c++) {
+                if (availability_bits[c * period_words + period_words - 1] & ~last_periods) return false;
+                if (conflict_words > 0 && (conflict_bits[c * conflict_words + conflict_words - 1] & ~last_courses)) return false;
+                if (course_curricula_start[c] > course_curricula_start[c + 1]) return false;
+                if (course_first_event[c + 1] - course_first_event[c] != course_vect[c].Lectures() || course_first_event[c] > course_first_event[c + 1])
+                    return false;
+            }
+            for (w = 0; w < course_curricula.size(); w++)
+                if (course_curricula[w] >= curricula) return false;
+            for (c = 0; c < courses; c++) {
+                for (e = course_first_event[c]; e < course_first_event[c + 1]; e++) {
+                    const Event& ev = event_vect[e];
+                    if (ev.course != c || ev.lecture != e - course_first_event[c] || ev.students != course_vect[c].Students()
+                        || ev.curricula_start != course_curricula_start[c] || ev.curricula_end != course_curricula_start[c + 1])
+                        return false;
                 }
             }
+            return true;
         }
 
-        int CourseIndex(const string& name) const {
-            for (unsigned i = 0; i < course_vect.size(); i++) {
-                if (course_vect[i].Name() == name) { return i; }
+        // Load an instance written by WriteBinary(): the compiled tables are copied as they are
+        bool ReadBinary(const MappedFile& file) {
+            BinaryReader is(file.Data(), file.Size());
+            unsigned i, j, n;
+            uint64_t memberships = 0;
+            char magic[8];
+
+            is.ReadArray(magic, 8);
+            name = is.ReadString();
+            courses = is.Read<uint32_t>();
+            rooms = is.Read<uint32_t>();
+            curricula = is.Read<uint32_t>();
+            periods = is.Read<uint32_t>();
+            periods_per_day = is.Read<uint32_t>();
+            n = is.Read<uint32_t>();
+            if (is.Fail() || periods_per_day == 0 || periods == 0 || periods % periods_per_day != 0) return false;
+            // Every record and bit row takes at least its fixed-size fields, so counts the file cannot hold are rejected before allocating
+            uint64_t bit_words = uint64_t(courses) * ((uint64_t(periods) + 63) / 64 + (uint64_t(courses) + 63) / 64);
+            if (uint64_t(courses) * 20 + uint64_t(rooms) * 8 + uint64_t(curricula) * 8 + uint64_t(n) * sizeof(Event) + bit_words * 8 > is.Remaining())
+                return false;
+            Resize();
+
+            for (i = 0; i < courses; i++) {
+                string course_name = is.ReadString(), teacher_name = is.ReadString();
+                unsigned lectures = is.Read<uint32_t>(), min_working_days = is.Read<uint32_t>(), students = is.Read<uint32_t>();
+                course_vect[i] = Course(course_name, teacher_name, lectures, min_working_days, students);
             }
-            return -1;
+            for (i = 1; i <= rooms; i++) {
+                string room_name = is.ReadString();
+                room_vect[i] = Room(room_name, is.Read<uint32_t>());
+            }
+            for (i = 0; i < curricula; i++) {
+                curricula_vect[i].SetName(is.ReadString());
+                unsigned curriculum_size = is.Read<uint32_t>();
+                if (curriculum_size > is.Remaining() / 4) return false;
+                for (j = 0; j < curriculum_size && !is.Fail(); j++) {
+                    unsigned member = is.Read<uint32_t>();
+                    if (member >= courses) return false;
+                    curricula_vect[i].AddMember(member);
+                }
+                memberships += curriculum_size;
+            }
+
+            is.ReadArray(availability_bits.data(), availability_bits.size());
+            is.ReadArray(conflict_bits.data(), conflict_bits.size());
+
+            course_curricula_start.resize(courses + 1);
+            is.ReadArray(course_curricula_start.data(), course_curricula_start.size());
+            if (is.Fail() || course_curricula_start[courses] != memberships) return false;
+            course_curricula.resize(memberships);
+            is.ReadArray(course_curricula.data(), course_curricula.size());
+            course_first_event.resize(courses + 1);
+            is.ReadArray(course_first_event.data(), course_first_event.size());
+            event_vect.resize(n);
+            is.ReadArray(event_vect.data(), event_vect.size());
+            if (is.Fail() || !ConsistentTables()) return false;
+
+            BuildConflictGraph();
+            CompileRecords();
+
+            IndexCourses();
+            IndexRooms();
+            IndexCurricula();
+            return true;
         }
 
-        int CurriculumIndex(const string& name) const {
-            for (unsigned i = 0; i < curricula_vect.size(); i++) {
-                if (curricula_vect[i].Name() == name) { return i; }
+    public:
+        // Reads either an ITC-2007 .ctt file or a binary instance written by WriteBinary()
+        Faculty(const string& file_name) : MIN_WORKING_DAYS_COST(5), CURRICULUM_COMPACTNESS_COST(2), ROOM_STABILITY_COST(1) {
+            MappedFile file(file_name);
+
+            if (file.Fail()) {
+                cerr << "Input file does not exist!" << endl;
+                exit(1);
+            }
+
+            if (file.Size() >= 8 && memcmp(file.Data(), BINARY_MAGIC, 8) == 0) {
+                if (!ReadBinary(file)) {
+                    cerr << "Corrupted binary instance file!" << endl;
+                    exit(1);
+                }
+            } else if (!ReadText(file)) {
+                cerr << "Corrupted instance file!" << endl;
+                exit(1);
             }
-            return -1;
         }
 
-        int RoomIndex(const string& name) const {
-            for (unsigned i = 0; i < room_vect.size(); i++) {
-                if (room_vect[i].Name() == name) { return i; }
+        // Names are indexed by views into the stored strings, so a Faculty is never copied
+        Faculty(const Faculty&) = delete;
+        Faculty& operator=(const Faculty&) = delete;
+
+        // Save the compiled instance (records, availability and conflict bits,
+        // curricula index and events) in a native-endian binary file
+        bool WriteBinary(const string& file_name) const {
+            ofstream os(file_name.c_str(), ios::binary);
+            BinaryWriter out(os);
+            unsigned i, j;
+
+            os.write(BINARY_MAGIC, 8);
+            out.WriteString(name);
+            out.Write<uint32_t>(courses);
+            out.Write<uint32_t>(rooms);
+            out.Write<uint32_t>(curricula);
+            out.Write<uint32_t>(periods);
+            out.Write<uint32_t>(periods_per_day);
+            out.Write<uint32_t>(event_vect.size());
+            for (i = 0; i < courses; i++) {
+                out.WriteString(course_vect[i].Name());
+                out.WriteString(course_vect[i].Teacher());
+                out.Write<uint32_t>(course_vect[i].Lectures());
+                out.Write<uint32_t>(course_vect[i].MinWorkingDays());
+                out.Write<uint32_t>(course_vect[i].Students());
+            }
+            for (i = 1; i <= rooms; i++) {
+                out.WriteString(room_vect[i].Name());
+                out.Write<uint32_t>(room_vect[i].Capacity());
             }
-            return -1;
+            for (i = 0; i < curricula; i++) {
+                out.WriteString(curricula_vect[i].Name());
+                out.Write<uint32_t>(curricula_vect[i].Size());
+                for (j = 0; j < curricula_vect[i].Size(); j++)
+                    out.Write<uint32_t>(curricula_vect[i][j]);
+            }
+
+            out.WriteArray(availability_bits);
+            out.WriteArray(conflict_bits);
+            out.WriteArray(course_curricula_start);
+            out.WriteArray(course_curricula);
+            out.WriteArray(course_first_event);
+            out.WriteArray(event_vect);
+            return bool(os);
+        }
+
+        int CourseIndex(string_view name) const {
+            auto it = course_index.find(name);
+            return it == course_index.end() ? -1 : it->second;
+        }
+
+        int CurriculumIndex(string_view name) const {
+            auto it = curriculum_index.find(name);
+            return it == curriculum_index.end() ? -1 : it->second;
+        }
+
+        int RoomIndex(string_view name) const {
+            auto it = room_index.find(name);
+            return it == room_index.end() ? -1 : it->second;
         }
 
         bool CurriculumMember(unsigned c, unsigned g) const {
-            for (unsigned i = 0; i < curricula_vect[g].Size(); i++) {
-                if (curricula_vect[g][i] == c) { return true; }
+            for (const unsigned* it = CourseCurriculaBegin(c); it != CourseCurriculaEnd(c); ++it) {
+                if (*it == g) { return true; }
             }
             return false;
         }
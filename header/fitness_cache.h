@@ -0,0 +1,59 @@
+#ifndef FITNESS_CACHE_H
+#define FITNESS_CACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+// 64-bit hash of a chromosome
+inline uint64_t hash_chromosome(const vector<int>& chromosome) {
+    uint64_t h = 0x9e3779b97f4a7c15ULL ^ chromosome.size();
+    for (int gene : chromosome) {
+        h = (h ^ uint32_t(gene)) * 0xbf58476d1ce4e5b9ULL;
+        h ^= h >> 31;
+    }
+    return h;
+}
+
+// Bounded table of the fitness of chromosomes already evaluated, shared by all
+// workers without locks. Each slot holds (key ^ data, data): a slot overwritten
+// by another thread in the middle of a read fails the key check and is reported
+// as a miss. A new entry always replaces the old one in its slot. Hits are
+// counted by the workers, so lookups touch no shared counter.
+class FitnessCache {
+    private:
+        struct Slot {
+            atomic<uint64_t> check{0}, data{0};
+        };
+
+        static constexpr uint64_t VALID = uint64_t(1) << 32;
+
+        vector<Slot> slots;
+        uint64_t mask;
+
+    public:
+        // Table of 2^bits entries
+        FitnessCache(unsigned bits) : slots(size_t(1) << bits), mask((uint64_t(1) << bits) - 1) {}
+
+        bool Find(uint64_t key, int& fitness) {
+            const Slot& slot = slots[key & mask];
+            uint64_t data = slot.data.load(memory_order_relaxed);
+            uint64_t check = slot.check.load(memory_order_relaxed);
+            if (!(data & VALID) || (check ^ data) != key) return false;
+            fitness = int32_t(uint32_t(data));
+            return true;
+        }
+
+        void Insert(uint64_t key, int fitness) {
+            Slot& slot = slots[key & mask];
+            uint64_t data = VALID | uint32_t(fitness);
+            slot.data.store(data, memory_order_relaxed);
+            slot.check.store(key ^ data, memory_order_relaxed);
+        }
+
+        size_t Size() const { return slots.size(); }
+};
+
+#endif
@@ -0,0 +1,856 @@
+#ifndef GA_H
+#define GA_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <string>
+#include <vector>
+#include "faculty.h"
+#include "cost_engine.h"
+#include "batch_scorer.h"
+#include "occupancy.h"
+#include "thread_pool.h"
+#include "mailbox.h"
+#include "local_search.h"
+#include "fitness_cache.h"
+#include "operators.h"
+#include "rng.h"
+#include "mapped_file.h"
+#include "telemetry.h"
+
+using namespace std;
+
+struct GAParameters {
+    int pop_size = 30;
+    int max_generations = 100; // 0 = no limit
+    double time_limit = 0;     // wall-clock budget in seconds, 0 = no limit
+    double crossover_rate = 0.8;
+    double mutation_rate = 0.1;
+    CrossoverType crossover = CrossoverType::Order;
+    bool use_elitism = true;
+    int elite_count = 5;
+    int tournament_size = 3;
+
+    // adaptive control: crossover and mutation rates follow the success of the
+    // children, within [min_rate, max_rate]
+    bool adaptive = false;
+    double target_success = 0.2; // share of improving children the mutation rate aims at
+    double min_rate = 0.001, max_rate = 0.95;
+    // stagnation: after restart_after generations without a new best, all but the
+    // elites are replaced by random individuals; after stop_after the run ends (0 = never)
+    int restart_after = 0;
+    int stop_after = 0;
+
+    unsigned seed = 1;
+    unsigned threads = 1;
+
+    // island model
+    unsigned islands = 1;
+    unsigned migration_interval = 10;
+    unsigned migrants = 2;
+    bool random_topology = false;
+
+    // memetic mode
+    LocalSearchParameters local_search;
+
+    // decoder checkpoint every checkpoint_interval genes, 0 = always decode from gene 0.
+    // Off by default: each checkpoint is a full copy of the decoder state, and with the
+    // default operators children rarely share a long prefix with a parent
+    unsigned checkpoint_interval = 0;
+
+    // fitness cache of 2^cache_bits entries shared by all workers, 0 = off; not
+    // used in memetic mode, where the fitness of a chromosome is not deterministic
+    unsigned cache_bits = 16;
+
+    // anytime output: the best solution is rewritten here whenever it improves
+    string solution_file;
+    // population and random state saved every checkpoint_seconds and at the end
+    // (single population only); resume_file continues a saved run
+    string checkpoint_file, resume_file;
+    double checkpoint_seconds = 60;
+    // per-generation CSV (or JSON, for a .json name) telemetry, single population only
+    string telemetry_file;
+
+    int Elites() const { return use_elitism ? min(elite_count, pop_size) : 0; }
+};
+
+struct EventAssignment {
+    int course_id;
+    int lecture_idx;
+    int timeslot;
+    int room_id;
+};
+
+// Decoder state saved before genes 0, interval, 2 * interval, ...
+struct DecoderCheckpoints {
+    vector<uint64_t> states;   // Occupancy state, Occupancy::StateWords() words per checkpoint
+    vector<unsigned> assigned; // Number of assignments made before the checkpoint
+};
+
+struct Individual {
+    vector<int> chromosome; // Permutation of event_ids (0 .. total_events-1)
+    int fitness = 0;
+    vector<EventAssignment> timetable; // Timetable improved by local search (memetic mode only)
+    vector<EventAssignment> assignments; // Decoded chromosome (checkpointed decoding only)
+    DecoderCheckpoints checkpoints;
+
+    bool operator<(const Individual& other) const {
+        return fitness < other.fitness;
+    }
+};
+
+inline Individual gen_random_individual(const Faculty& faculty, Rng& rng) {
+    Individual ind; // Each individual is a whole timetable on its own
+
+    ind.chromosome.resize(faculty.Events());
+    iota(ind.chromosome.begin(), ind.chromosome.end(), 0);  // Fill with 0..N-1
+    rng.Shuffle(ind.chromosome.begin(), ind.chromosome.end());
+
+    return ind;
+}
+
+// Greedy step of the decoder: place event_id in the first feasible cell, if any
+inline void decode_event(int event_id, const Faculty& faculty, Occupancy& occupancy, vector<EventAssignment>& assignments) {
+    unsigned period, room_id;
+    // Room too small is a soft constraint: the first free room is taken
+    if (occupancy.FirstFit(event_id, period, room_id)) {
+        const Event& event = faculty.EventVector(event_id);
+        assignments.push_back({(int)event.course, (int)event.lecture, (int)period, (int)room_id});
+        occupancy.Assign(event_id, period, room_id);
+    }
+}
+
+// Decode into assignments, reusing its storage
+inline void decode_individual(const Individual& ind, const Faculty& faculty, Occupancy& occupancy, vector<EventAssignment>& assignments) {
+    assignments.clear();
+    assignments.reserve(ind.chromosome.size());
+    occupancy.Clear();
+
+    for (int event_id : ind.chromosome) {
+        decode_event(event_id, faculty, occupancy, assignments);
+    }
+}
+
+inline vector<EventAssignment> decode_individual(const Individual& ind, const Faculty& faculty, Occupancy& occupancy) {
+    vector<EventAssignment> assignments;
+    decode_individual(ind, faculty, occupancy, assignments);
+    return assignments;
+}
+
+inline size_t common_prefix(const vector<int>& a, const vector<int>& b) {
+    size_t n = min(a.size(), b.size()), i = 0;
+    while (i < n && a[i] == b[i]) i++;
+    return i;
+}
+
+// decode_individual() into ind.assignments, saving the decoder state every interval
+// genes in ind.checkpoints. If parent was decoded the same way, decoding resumes
+// from its last checkpoint before the first gene where the two chromosomes differ.
+// Returns the number of genes that were not replayed.
+inline unsigned decode_checkpointed(Individual& ind, const Individual* parent, const Faculty& faculty, Occupancy& occupancy, unsigned interval) {
+    DecoderCheckpoints& saved = ind.checkpoints;
+    size_t words = occupancy.StateWords(), k = 0;
+    unsigned size = ind.chromosome.size();
+
+    if (parent && !parent->checkpoints.assigned.empty()) {
+        k = min(common_prefix(ind.chromosome, parent->chromosome) / interval, parent->checkpoints.assigned.size() - 1);
+    }
+    if (k > 0) {
+        const DecoderCheckpoints& from = parent->checkpoints;
+        saved.states.assign(from.states.begin(), from.states.begin() + (k + 1) * words);
+        saved.assigned.assign(from.assigned.begin(), from.assigned.begin() + k + 1);
+        ind.assignments.assign(parent->assignments.begin(), parent->assignments.begin() + saved.assigned[k]);
+        occupancy.Restore(saved.states.data() + k * words);
+    } else {
+        saved.states.clear();
+        saved.assigned.clear();
+        ind.assignments.clear();
+        occupancy.Clear();
+    }
+
+    for (unsigned i = k * interval; i < size; i++) {
+        if (i % interval == 0 && i / interval == saved.assigned.size()) {
+            saved.assigned.push_back(ind.assignments.size());
+            saved.states.resize(saved.states.size() + words);
+            occupancy.Save(saved.states.data() + saved.states.size() - words);
+        }
+        decode_event(ind.chromosome[i], faculty, occupancy, ind.assignments);
+    }
+    return k * interval;
+}
+
+inline int score_assignments(const vector<EventAssignment>& assignments, CostEngine& engine) {
+    engine.Clear();
+    for (const auto& a : assignments) {
+        engine.Assign(a.course_id, a.timeslot, a.room_id);
+    }
+
+    return engine.Cost();
+}
+
+inline int evaluate_fitness(const Individual& ind, const Faculty& faculty, Occupancy& occupancy, CostEngine& engine) {
+    return score_assignments(decode_individual(ind, faculty, occupancy), engine);
+}
+
+// --- Selection (Tournament) ---
+// Returns the index of the winner
+inline size_t tournament_selection(const vector<Individual>& population, Rng& rng, int k = 3) {
+    size_t best = 0;
+    int best_fitness = INT_MAX;
+    for (int i = 0; i < k; ++i) {
+        size_t r = rng.Below(population.size());
+        if (population[r].fitness < best_fitness) {
+            best = r;
+            best_fitness = population[r].fitness;
+        }
+    }
+    return best;
+}
+
+// Two preallocated generations that trade places every generation, so chromosome
+// buffers are reused instead of reallocated and individuals are never copied
+struct Population {
+    vector<Individual> current, next; // current is kept sorted, best first
+    vector<pair<int, unsigned> > keys;
+
+    Population(size_t size = 0) : current(size), next(size) {}
+
+    Individual& operator[](size_t i) { return current[i]; }
+    const Individual& operator[](size_t i) const { return current[i]; }
+    size_t Size() const { return current.size(); }
+
+    // Sort by (fitness, position) keys and move individuals into place by swapping buffers
+    void Sort() {
+        keys.resize(current.size());
+        for (unsigned i = 0; i < current.size(); ++i) keys[i] = {current[i].fitness, i};
+        sort(keys.begin(), keys.end());
+        for (unsigned i = 0; i < current.size(); ++i) swap(next[i], current[keys[i].second]);
+        current.swap(next);
+    }
+};
+
+// Per-thread state: decoder and evaluator scratch data plus an independent random stream
+struct Worker {
+    const Faculty& faculty;
+    const LocalSearchParameters local_search_params;
+    const unsigned checkpoint_interval;
+    FitnessCache* cache;
+    Occupancy occupancy;
+    CostEngine engine;
+    BatchScorer scorer;
+    LocalSearch local_search;
+    OperatorScratch scratch;
+    Rng rng;
+    unsigned long evaluations = 0, decoded_genes = 0, resumed_genes = 0, cache_hits = 0;
+    double decode_seconds = 0;
+    Counters counters; // phase timers (INSTRUMENT only)
+    // children bred with and without crossover, and how many beat both parents
+    unsigned long crossed = 0, crossed_improved = 0, copied = 0, copied_improved = 0;
+
+    Worker(const Faculty& f, unsigned seed, unsigned id, const LocalSearchParameters& ls = LocalSearchParameters(), unsigned interval = 0,
+           FitnessCache* shared_cache = nullptr)
+        : faculty(f), local_search_params(ls), checkpoint_interval(interval), cache(ls.moves > 0 ? nullptr : shared_cache),
+          occupancy(f), engine(f), scorer(f), local_search(f, engine), rng(seed, id) {}
+    // local_search refers to engine, so a worker never moves: workers live in a
+    // deque, which builds them in place and keeps them where they are
+    Worker(const Worker&) = delete;
+    Worker(Worker&&) = delete;
+    Worker& operator=(const Worker&) = delete;
+    Worker& operator=(Worker&&) = delete;
+
+    // evaluate_fitness(), also counting evaluations and timing the decoder. With
+    // checkpoints, decoding resumes from parent (the individual ind was bred from,
+    // if any). In memetic mode the decoded timetable is then improved by local
+    // search and kept in ind.timetable; the chromosome is left as it is.
+    // Chromosomes found in the cache are not decoded at all.
+    int Evaluate(Individual& ind, const Individual* parent = nullptr) {
+        uint64_t key = 0;
+        int fitness;
+        if (cache) {
+            key = hash_chromosome(ind.chromosome);
+            if (cache->Find(key, fitness)) {
+                cache_hits++;
+                // The slot may hold a timetable of an earlier individual, which
+                // write_solution() would take in place of decoding the chromosome
+                ind.timetable.clear();
+                // With checkpoints, keep them valid for the children of ind
+                if (checkpoint_interval > 0 && parent && parent->chromosome == ind.chromosome) {
+                    ind.assignments = parent->assignments;
+                    ind.checkpoints = parent->checkpoints;
+                } else {
+                    ind.assignments.clear();
+                    ind.checkpoints.states.clear();
+                    ind.checkpoints.assigned.clear();
+                }
+                return fitness;
+            }
+        }
+
+        auto start = chrono::steady_clock::now();
+        {
+            INSTRUMENT_PHASE(counters, PHASE_DECODE);
+            if (checkpoint_interval > 0) {
+                resumed_genes += decode_checkpointed(ind, parent, faculty, occupancy, checkpoint_interval);
+            } else {
+                decode_individual(ind, faculty, occupancy, ind.assignments);
+            }
+        }
+        decode_seconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        evaluations++;
+        decoded_genes += ind.chromosome.size();
+        {
+            INSTRUMENT_PHASE(counters, PHASE_SCORE);
+            // Local search starts from the timetable loaded into the engine
+            if (local_search_params.moves > 0 || !scorer.Supported()) fitness = score_assignments(ind.assignments, engine);
+            else fitness = scorer.Score(ind.assignments);
+        }
+        ind.timetable.clear();
+        if (cache) cache->Insert(key, fitness);
+
+        if (local_search_params.moves > 0) {
+            INSTRUMENT_PHASE(counters, PHASE_LOCAL_SEARCH);
+            fitness = local_search.Run(local_search_params, rng);
+            ind.timetable.reserve(faculty.Events());
+            for (unsigned p = 0; p < faculty.Periods(); p++) {
+                for (unsigned i = 0; i < engine.PeriodCoursesNo(p); i++) {
+                    unsigned c = engine.PeriodCourses(p, i);
+                    ind.timetable.push_back({(int)c, 0, (int)p, (int)engine(c, p)});
+                }
+            }
+        }
+        return fitness;
+    }
+
+    // Move the instrumentation counters of the worker and its decoder into total
+    void CollectCounters(Counters& total) {
+        total += counters;
+        total += occupancy.counters;
+        counters = Counters();
+        occupancy.counters = Counters();
+    }
+};
+
+// Fill population with random individuals from position first on (restarts keep the
+// individuals before it); individual j is built by worker j % pool.Size()
+inline void init_population(Population& population, const Faculty& faculty, ThreadPool& pool, deque<Worker>& workers, size_t first = 0) {
+    unsigned threads = pool.Size();
+    pool.Run([&](unsigned w) {
+        Worker& worker = workers[w];
+        for (size_t j = first + w; j < population.Size(); j += threads) {
+            population[j] = gen_random_individual(faculty, worker.rng);
+            population[j].fitness = worker.Evaluate(population[j]);
+        }
+    });
+
+    population.Sort(); // Best first
+}
+
+// Replace population by the next generation. Children are bred and evaluated in
+// parallel, child j always by worker j % pool.Size(), so a run is reproducible
+// for a given seed and thread count.
+inline void next_generation(Population& population, const GAParameters& params, ThreadPool& pool, deque<Worker>& workers) {
+    int elites = params.Elites();
+    unsigned threads = pool.Size();
+    const vector<Individual>& parents = population.current;
+    vector<Individual>& children = population.next;
+
+    pool.Run([&](unsigned w) {
+        Worker& worker = workers[w];
+        for (size_t j = elites + w; j < children.size(); j += threads) {
+            size_t first, second;
+            {
+                INSTRUMENT_PHASE(worker.counters, PHASE_SELECTION);
+                first = tournament_selection(parents, worker.rng, params.tournament_size);
+                second = tournament_selection(parents, worker.rng, params.tournament_size);
+            }
+            const Individual& parent1 = parents[first];
+            const Individual& parent2 = parents[second];
+
+            // The child's chromosome buffer is reused
+            bool crossed = worker.rng.Chance(params.crossover_rate);
+            {
+                INSTRUMENT_PHASE(worker.counters, PHASE_CROSSOVER);
+                if (crossed) {
+                    crossover(params.crossover, parent1.chromosome, parent2.chromosome, children[j].chromosome, worker.rng, worker.scratch);
+                } else {
+                    // No crossover, the child is parent 1
+                    children[j].chromosome.assign(parent1.chromosome.begin(), parent1.chromosome.end());
+                }
+            }
+            {
+                INSTRUMENT_PHASE(worker.counters, PHASE_MUTATION);
+                swap_mutation(children[j].chromosome, worker.rng, params.mutation_rate);
+            }
+            // Resume decoding from the parent sharing the longer prefix
+            const Individual* resume = &parent1;
+            if (common_prefix(children[j].chromosome, parent2.chromosome) > common_prefix(children[j].chromosome, parent1.chromosome)) {
+                resume = &parent2;
+            }
+            children[j].fitness = worker.Evaluate(children[j], resume);
+
+            bool improved = children[j].fitness < min(parent1.fitness, parent2.fitness);
+            if (crossed) {
+                worker.crossed++;
+                worker.crossed_improved += improved;
+            } else {
+                worker.copied++;
+                worker.copied_improved += improved;
+            }
+        }
+    });
+
+    // Elitism: carry over the best individuals
+    for (int i = 0; i < elites; ++i) {
+        swap(children[i], population.current[i]);
+    }
+
+    population.current.swap(population.next);
+    population.Sort();
+}
+
+// What a run did, for progress reports and benchmarks
+struct RunStats {
+    unsigned long evaluations = 0, local_search_moves = 0, local_search_accepted = 0;
+    unsigned long decoded_genes = 0, resumed_genes = 0, cache_hits = 0, restarts = 0;
+    double seconds = 0, decode_seconds = 0;
+    bool checkpoint_failed = false; // the final checkpoint could not be written
+    bool telemetry_failed = false;  // some telemetry could not be written
+    vector<pair<double, int> > trace; // (elapsed seconds, best fitness) at every improvement
+    Counters counters; // instrumentation totals (INSTRUMENT only)
+
+    void Add(const deque<Worker>& workers) {
+        for (const auto& w : workers) {
+            evaluations += w.evaluations;
+            decoded_genes += w.decoded_genes;
+            resumed_genes += w.resumed_genes;
+            cache_hits += w.cache_hits;
+            decode_seconds += w.decode_seconds;
+            local_search_moves += w.local_search.moves;
+            local_search_accepted += w.local_search.accepted;
+            counters += w.counters;
+            counters += w.occupancy.counters;
+        }
+    }
+};
+
+// Mean, standard deviation and number of distinct values of the fitness in a sorted population
+inline void fitness_statistics(const Population& population, double& mean, double& deviation, unsigned& distinct) {
+    double sum = 0, squares = 0;
+    distinct = 0;
+    for (size_t i = 0; i < population.Size(); ++i) {
+        sum += population[i].fitness;
+        squares += double(population[i].fitness) * population[i].fitness;
+        if (i == 0 || population[i].fitness != population[i - 1].fitness) distinct++;
+    }
+    mean = sum / population.Size();
+    deviation = sqrt(max(0.0, squares / population.Size() - mean * mean));
+}
+
+// Adaptive control and stagnation handling of one population, updated after
+// every generation
+struct Adaptation {
+    double crossover_rate, mutation_rate; // for the next generation
+    int best = INT_MAX;
+    int last_improvement = 0, last_restart = 0; // generations
+    unsigned restarts = 0;
+
+    Adaptation(const GAParameters& params) : crossover_rate(params.crossover_rate), mutation_rate(params.mutation_rate) {}
+
+    // params with the current rates
+    GAParameters Current(const GAParameters& params) const {
+        GAParameters current = params;
+        current.crossover_rate = crossover_rate;
+        current.mutation_rate = mutation_rate;
+        return current;
+    }
+
+    // Call after generation gen with the new best fitness. Takes the success
+    // counts of the workers (and resets them) and, with params.adaptive, sets the
+    // rates of the next generation: the mutation rate by the 1/5 success rule
+    // around target_success, the crossover rate towards the share of success
+    // that crossover children had.
+    void Update(const GAParameters& params, deque<Worker>& workers, int gen, int best_fitness) {
+        unsigned long crossed = 0, crossed_improved = 0, copied = 0, copied_improved = 0;
+        for (auto& w : workers) {
+            crossed += w.crossed;
+            crossed_improved += w.crossed_improved;
+            copied += w.copied;
+            copied_improved += w.copied_improved;
+            w.crossed = w.crossed_improved = w.copied = w.copied_improved = 0;
+        }
+        if (best_fitness < best) {
+            best = best_fitness;
+            last_improvement = gen;
+        }
+        if (!params.adaptive || crossed + copied == 0) return;
+
+        double success = double(crossed_improved + copied_improved) / (crossed + copied);
+        mutation_rate *= success > params.target_success ? 1.2 : 0.85;
+        mutation_rate = min(max(mutation_rate, params.min_rate), params.max_rate);
+
+        double crossed_success = (crossed_improved + 1.0) / (crossed + 2.0), copied_success = (copied_improved + 1.0) / (copied + 2.0);
+        crossover_rate = 0.8 * crossover_rate + 0.2 * crossed_success / (crossed_success + copied_success);
+        crossover_rate = min(max(crossover_rate, params.min_rate), params.max_rate);
+    }
+
+    // True if the population should be restarted after generation gen; the rates start over
+    bool Restart(const GAParameters& params, int gen) {
+        if (params.restart_after <= 0 || gen - max(last_improvement, last_restart) < params.restart_after) return false;
+        last_restart = gen;
+        restarts++;
+        crossover_rate = params.crossover_rate;
+        mutation_rate = params.mutation_rate;
+        return true;
+    }
+
+    bool Stop(const GAParameters& params, int gen) const {
+        return params.stop_after > 0 && gen - last_improvement >= params.stop_after;
+    }
+};
+
+// One independent population of the island model, evolved by a single thread
+struct Island {
+    Population population;
+    vector<Individual> immigrants;
+    Mailbox<Individual> inbox;
+    unsigned received = 0, sent = 0;
+
+    double MeanFitness() const {
+        double sum = 0;
+        for (const auto& ind : population.current) sum += ind.fitness;
+        return sum / population.Size();
+    }
+};
+
+// Write the timetable of ind in the ITC-2007 solution format. The file is
+// written under a temporary name and renamed, so readers never see it half done.
+inline bool write_solution(const Individual& ind, const Faculty& faculty, const string& file_name) {
+    string temporary = file_name + ".tmp";
+    {
+        ofstream outfile(temporary.c_str());
+        if (!outfile) return false;
+
+        Occupancy occupancy(faculty);
+        auto assignments = ind.timetable.empty() ? decode_individual(ind, faculty, occupancy) : ind.timetable;
+        for (const auto& a : assignments) {
+            int day = a.timeslot / faculty.PeriodsPerDay();
+            int day_period = a.timeslot % faculty.PeriodsPerDay();
+            outfile << faculty.CourseVector(a.course_id).Name() << " " << faculty.RoomVector(a.room_id).Name() << " " << day << " " << day_period << "\n";
+        }
+        if (!outfile.flush()) return false;
+    }
+    return rename(temporary.c_str(), file_name.c_str()) == 0;
+}
+
+// --- Checkpoints ---
+// Binary snapshot of a single-population run after a generation: the population
+// with its fitness (and local search timetables), the adaptive control state and
+// the state of every worker's random stream, so a resumed run continues exactly
+// where the saved one was.
+constexpr char CHECKPOINT_MAGIC[9] = "TRJCKPT2";
+
+inline bool save_checkpoint(const string& file_name, const Faculty& faculty, const Population& population,
+                            const deque<Worker>& workers, const Adaptation& control, int generation, double seconds) {
+    string temporary = file_name + ".tmp";
+    {
+        ofstream os(temporary.c_str(), ios::binary);
+        BinaryWriter out(os);
+        uint64_t state[4];
+
+        os.write(CHECKPOINT_MAGIC, 8);
+        out.WriteString(faculty.Name());
+        out.Write<uint32_t>(faculty.Events());
+        out.Write<uint32_t>(population.Size());
+        out.Write<uint32_t>(workers.size());
+        out.Write<int32_t>(generation);
+        out.Write<double>(seconds);
+        out.Write<double>(control.crossover_rate);
+        out.Write<double>(control.mutation_rate);
+        out.Write<int32_t>(control.best);
+        out.Write<int32_t>(control.last_improvement);
+        out.Write<int32_t>(control.last_restart);
+        out.Write<uint32_t>(control.restarts);
+        for (const auto& w : workers) {
+            w.rng.SaveState(state);
+            out.WriteArray(state, 4);
+        }
+        for (const auto& ind : population.current) {
+            out.Write<int32_t>(ind.fitness);
+            out.WriteArray(ind.chromosome);
+            out.Write<uint32_t>(ind.timetable.size());
+            out.WriteArray(ind.timetable);
+        }
+        if (!os.flush()) return false;
+    }
+    return rename(temporary.c_str(), file_name.c_str()) == 0;
+}
+
+// Restore a checkpoint taken on the same instance with the same population size
+// and number of threads; returns false if it does not match or is damaged. Every
+// value read is checked before use: chromosomes must be permutations of the
+// events, timetable entries must name existing lectures, periods and rooms, and
+// the random states and adaptive control must be ones a run can produce.
+inline bool load_checkpoint(const string& file_name, const Faculty& faculty, Population& population,
+                            deque<Worker>& workers, Adaptation& control, int& generation, double& seconds) {
+    MappedFile file(file_name);
+    if (file.Fail() || file.Size() < 8 || memcmp(file.Data(), CHECKPOINT_MAGIC, 8) != 0) return false;
+    BinaryReader is(file.Data() + 8, file.Size() - 8);
+    uint64_t state[4];
+    vector<char> seen(faculty.Events());
+    auto valid_rate = [](double rate) { return rate >= 0 && rate <= 1; }; // false for NaN too
+
+    if (is.ReadString() != faculty.Name() || is.Read<uint32_t>() != faculty.Events()
+        || is.Read<uint32_t>() != population.Size() || is.Read<uint32_t>() != workers.size()) return false;
+    generation = is.Read<int32_t>();
+    seconds = is.Read<double>();
+    control.crossover_rate = is.Read<double>();
+    control.mutation_rate = is.Read<double>();
+    control.best = is.Read<int32_t>();
+    control.last_improvement = is.Read<int32_t>();
+    control.last_restart = is.Read<int32_t>();
+    control.restarts = is.Read<uint32_t>();
+    if (is.Fail() || generation < 0 || !(seconds >= 0 && seconds < 1e18) || !valid_rate(control.crossover_rate)
+        || !valid_rate(control.mutation_rate) || control.last_improvement < 0 || control.last_improvement > generation
+        || control.last_restart < 0 || control.last_restart > generation || control.restarts > unsigned(generation))
+        return false;
+    for (auto& w : workers) {
+        is.ReadArray(state, 4);
+        if (is.Fail() || (state[0] | state[1] | state[2] | state[3]) == 0) return false; // xoshiro never reaches the zero state
+        w.rng.LoadState(state);
+    }
+    for (auto& ind : population.current) {
+        ind.fitness = is.Read<int32_t>();
+        ind.chromosome.resize(faculty.Events());
+        is.ReadArray(ind.chromosome.data(), ind.chromosome.size());
+        if (is.Fail()) return false;
+        fill(seen.begin(), seen.end(), 0);
+        for (int gene : ind.chromosome) {
+            if (gene < 0 || unsigned(gene) >= faculty.Events() || seen[gene]) return false;
+            seen[gene] = 1;
+        }
+        uint32_t entries = is.Read<uint32_t>();
+        if (is.Fail() || entries > faculty.Events()) return false;
+        ind.timetable.resize(entries);
+        is.ReadArray(ind.timetable.data(), ind.timetable.size());
+        if (is.Fail()) return false;
+        for (const auto& a : ind.timetable)
+            if (a.course_id < 0 || unsigned(a.course_id) >= faculty.Courses() || a.lecture_idx < 0
+                || unsigned(a.lecture_idx) >= faculty.Lectures(a.course_id) || a.timeslot < 0 || unsigned(a.timeslot) >= faculty.Periods()
+                || a.room_id < 1 || unsigned(a.room_id) > faculty.Rooms())
+                return false;
+        ind.assignments.clear();
+        ind.checkpoints = DecoderCheckpoints();
+    }
+    return !is.Fail();
+}
+
+// Evolve a single population on params.threads workers until max_generations
+// or time_limit. Progress lines go to progress, if given, and a telemetry record
+// to params.telemetry_file after every generation; returns the final population,
+// best first.
+inline Population run_ga(const Faculty& faculty, const GAParameters& params, RunStats& stats, ostream* progress = nullptr) {
+    auto start = chrono::steady_clock::now(), last_checkpoint = start;
+    double resumed_seconds = 0;
+    int gen = 0;
+    auto elapsed = [&]() { return resumed_seconds + chrono::duration<double>(chrono::steady_clock::now() - start).count(); };
+    ThreadPool pool(params.threads);
+    unique_ptr<FitnessCache> cache(params.cache_bits > 0 ? new FitnessCache(params.cache_bits) : nullptr);
+    deque<Worker> workers;
+    for (unsigned w = 0; w < params.threads; ++w) {
+        workers.emplace_back(faculty, params.seed, w, params.local_search, params.checkpoint_interval, cache.get());
+    }
+
+    Population population(params.pop_size);
+    Adaptation control(params);
+    unique_ptr<TelemetryWriter> telemetry(params.telemetry_file.empty() ? nullptr : new TelemetryWriter(params.telemetry_file));
+    if (telemetry && telemetry->Fail()) {
+        cerr << "Telemetry file " << params.telemetry_file << " cannot be written!" << endl;
+        exit(1);
+    }
+    unsigned long evaluations = 0;
+    double last_seconds = 0;
+    // Telemetry of the generation just finished; moves the workers' counters into stats
+    auto record = [&](int generation) {
+        GenerationRecord r;
+        unsigned long total = 0;
+        r.generation = generation;
+        r.crossover_rate = control.crossover_rate;
+        r.mutation_rate = control.mutation_rate;
+        r.seconds = elapsed();
+        r.best = population[0].fitness;
+        fitness_statistics(population, r.mean, r.deviation, r.distinct);
+        for (auto& w : workers) {
+            total += w.evaluations;
+            w.CollectCounters(r.counters);
+        }
+        r.evaluations = total - evaluations;
+        r.evaluations_per_second = r.seconds > last_seconds ? r.evaluations / (r.seconds - last_seconds) : 0;
+        evaluations = total;
+        last_seconds = r.seconds;
+        stats.counters += r.counters;
+        if (telemetry) telemetry->Write(r);
+    };
+
+    if (params.resume_file.empty()) {
+        init_population(population, faculty, pool, workers);
+    } else if (!load_checkpoint(params.resume_file, faculty, population, workers, control, gen, resumed_seconds)) {
+        cerr << "Checkpoint " << params.resume_file << " is damaged or does not match this run!" << endl;
+        exit(1);
+    }
+    last_seconds = resumed_seconds;
+    record(gen);
+    if (params.resume_file.empty()) control.Update(params, workers, gen, population[0].fitness);
+    // Anytime solutions and checkpoints that cannot be written are reported, the run goes on
+    auto save_solution = [&]() {
+        if (!params.solution_file.empty() && !write_solution(population[0], faculty, params.solution_file))
+            cerr << "Failed to write " << params.solution_file << endl;
+    };
+    auto save = [&](int generation) {
+        bool saved = save_checkpoint(params.checkpoint_file, faculty, population, workers, control, generation, elapsed());
+        if (!saved) cerr << "Failed to write checkpoint " << params.checkpoint_file << endl;
+        return saved;
+    };
+    stats.trace.emplace_back(elapsed(), population[0].fitness);
+    save_solution();
+
+    for (; (params.max_generations <= 0 || gen < params.max_generations) && (params.time_limit <= 0 || elapsed() < params.time_limit)
+           && !control.Stop(params, gen); ++gen) {
+        next_generation(population, control.Current(params), pool, workers);
+        record(gen + 1);
+        control.Update(params, workers, gen + 1, population[0].fitness);
+        if (control.Restart(params, gen + 1)) {
+            init_population(population, faculty, pool, workers, max(params.Elites(), 1));
+        }
+
+        if (population[0].fitness < stats.trace.back().second) {
+            stats.trace.emplace_back(elapsed(), population[0].fitness);
+            save_solution();
+        }
+        // Print progress
+        if (progress) {
+            *progress << "Generation " << gen + 1 << ": Best fitness = " << population[0].fitness << "\n";
+        }
+        if (!params.checkpoint_file.empty()
+            && chrono::duration<double>(chrono::steady_clock::now() - last_checkpoint).count() >= params.checkpoint_seconds) {
+            save(gen + 1);
+            last_checkpoint = chrono::steady_clock::now();
+        }
+    }
+    if (!params.checkpoint_file.empty()) {
+        stats.checkpoint_failed = !save(gen);
+    }
+    if (telemetry && !telemetry->Close()) {
+        cerr << "Failed to write telemetry " << params.telemetry_file << endl;
+        stats.telemetry_failed = true;
+    }
+
+    stats.Add(workers);
+    stats.restarts += control.restarts;
+    stats.seconds = elapsed();
+    return population;
+}
+
+// Island model: every island runs the sequential GA on its own thread and
+// every migration_interval generations sends copies of its best migrants
+// individuals to the next island (ring) or to a random other island.
+// Islands never wait for each other, so runs are not bit-reproducible.
+// Returns the population of the island holding the global best.
+inline Population run_islands(const Faculty& faculty, const GAParameters& params, RunStats& stats, ostream* progress = nullptr) {
+    auto start = chrono::steady_clock::now();
+    unsigned islands = params.islands;
+    ThreadPool pool(islands);
+    vector<Island> island(islands);
+    unique_ptr<FitnessCache> cache(params.cache_bits > 0 ? new FitnessCache(params.cache_bits) : nullptr);
+    atomic<int> global_best(INT_MAX);
+    mutex stats_mutex, solution_mutex;
+    int written_best = INT_MAX; // fitness of the solution in params.solution_file
+    auto elapsed = [&]() { return chrono::duration<double>(chrono::steady_clock::now() - start).count(); };
+
+    pool.Run([&](unsigned k) {
+        Island& self = island[k];
+        ThreadPool inline_pool(1);
+        deque<Worker> workers;
+        workers.emplace_back(faculty, params.seed, k, params.local_search, params.checkpoint_interval, cache.get());
+        unsigned n_migrants = min<unsigned>(params.migrants, params.pop_size);
+
+        self.population = Population(params.pop_size);
+        init_population(self.population, faculty, inline_pool, workers);
+        Adaptation control(params);
+        control.Update(params, workers, 0, self.population[0].fitness);
+
+        for (int gen = 0; (params.max_generations <= 0 || gen < params.max_generations) && (params.time_limit <= 0 || elapsed() < params.time_limit)
+                          && !control.Stop(params, gen); ++gen) {
+            next_generation(self.population, control.Current(params), inline_pool, workers);
+            control.Update(params, workers, gen + 1, self.population[0].fitness);
+            if (control.Restart(params, gen + 1)) {
+                init_population(self.population, faculty, inline_pool, workers, max(params.Elites(), 1));
+            }
+
+            if ((gen + 1) % params.migration_interval == 0 && n_migrants > 0) {
+                unsigned target = (k + 1) % islands;
+                if (params.random_topology) {
+                    target = workers[0].rng.Below(islands - 1);
+                    if (target >= k) target++;
+                }
+                island[target].inbox.Post(self.population.current.data(), self.population.current.data() + n_migrants);
+                self.sent += n_migrants;
+
+                // Immigrants replace the worst individuals
+                if (self.inbox.TryCollect(self.immigrants) && !self.immigrants.empty()) {
+                    size_t n = min(self.immigrants.size(), self.population.Size());
+                    swap_ranges(self.immigrants.begin(), self.immigrants.begin() + n, self.population.current.end() - n);
+                    self.received += n;
+                    self.immigrants.clear();
+                    self.population.Sort();
+                }
+            }
+
+            int best = global_best.load();
+            if (self.population[0].fitness < best && !params.solution_file.empty()) {
+                lock_guard<mutex> lock(solution_mutex);
+                if (self.population[0].fitness < written_best) {
+                    if (write_solution(self.population[0], faculty, params.solution_file))
+                        written_best = self.population[0].fitness;
+                    else
+                        cerr << "Failed to write " << params.solution_file << endl;
+                }
+            }
+            while (self.population[0].fitness < best && !global_best.compare_exchange_weak(best, self.population[0].fitness));
+
+            // Print progress
+            if (k == 0 && progress) {
+                *progress << "Generation " << gen + 1 << ": Best fitness = " << global_best.load() << "\n";
+            }
+        }
+
+        lock_guard<mutex> lock(stats_mutex);
+        stats.Add(workers);
+        stats.restarts += control.restarts;
+    });
+
+    Population population;
+    for (unsigned k = 0; k < islands; ++k) {
+        if (progress) {
+            *progress << "Island " << k << ": best = " << island[k].population[0].fitness << ", mean = " << island[k].MeanFitness()
+                      << ", sent = " << island[k].sent << ", received = " << island[k].received << "\n";
+        }
+        if (population.Size() == 0 || island[k].population[0].fitness < population[0].fitness) {
+            swap(population, island[k].population);
+        }
+    }
+    stats.seconds = elapsed();
+    stats.trace.emplace_back(stats.seconds, population[0].fitness);
+    return population;
+}
+
+#endif
@@ -0,0 +1,110 @@
+#ifndef GENERATOR_H
+#define GENERATOR_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "rng.h"
+
+using namespace std;
+
+// Size and structure of a synthetic ITC-2007 instance
+struct GeneratorParameters {
+    unsigned courses = 1000;
+    unsigned rooms = 60;
+    unsigned days = 5;
+    unsigned periods_per_day = 6;
+    unsigned curricula = 400;
+    unsigned curriculum_size = 5;  // mean courses per curriculum
+    double overlap = 0.3;          // chance that a curriculum member is taken from courses already in a curriculum
+    double teacher_sharing = 1.5;  // mean courses per teacher
+    double unavailability = 0.05;  // share of (course, period) pairs that are unavailable
+    double load = 0.7;             // lectures / (rooms * periods)
+    unsigned long long seed = 1;
+};
+
+// Write a random instance in the .ctt format read by Faculty. Lectures are spread
+// over the courses so that they fill load of all room-periods; every course gets
+// at least one lecture and at most one per period, a minimum of working days no
+// larger than its lectures or the days, and a size drawn from the room capacities.
+inline void write_instance(ostream& os, const GeneratorParameters& g) {
+    Rng rng(g.seed);
+    unsigned periods = g.days * g.periods_per_day, c, r, q, p, i;
+    unsigned teachers = max(1u, unsigned(ceil(g.courses / max(1.0, g.teacher_sharing))));
+    char name[32];
+
+    auto course_name = [&](unsigned k) { snprintf(name, sizeof name, "c%05u", k); return string(name); };
+
+    vector<unsigned> capacity(g.rooms);
+    for (r = 0; r < g.rooms; r++) capacity[r] = 10 * rng.Between(2, 30);
+
+    double mean_lectures = max(1.0, g.load * g.rooms * periods / max(1u, g.courses));
+    vector<unsigned> lectures(g.courses);
+    unsigned long long constraints = 0;
+    vector<vector<unsigned> > unavailable(g.courses);
+    for (c = 0; c < g.courses; c++) {
+        lectures[c] = min<unsigned>(periods, max(1u, unsigned(mean_lectures * (0.5 + rng.Uniform()) + 0.5)));
+        for (p = 0; p < periods; p++)
+            if (rng.Chance(g.unavailability)) unavailable[c].push_back(p);
+        constraints += unavailable[c].size();
+    }
+
+    // Members of each curriculum: mostly fresh courses, shared ones with probability overlap
+    vector<vector<unsigned> > members(g.curricula);
+    vector<unsigned> fresh(g.courses), used;
+    for (c = 0; c < g.courses; c++) fresh[c] = c;
+    rng.Shuffle(fresh.begin(), fresh.end());
+    for (q = 0; q < g.curricula; q++) {
+        unsigned size = min(g.courses, rng.Between(max(1u, g.curriculum_size / 2), max(1u, g.curriculum_size * 3 / 2)));
+        for (unsigned tries = 0; members[q].size() < size && tries < 20 * size; tries++) {
+            bool shared = !used.empty() && (fresh.empty() || rng.Chance(g.overlap));
+            unsigned k = shared ? used[rng.Below(used.size())] : fresh.back();
+            if (find(members[q].begin(), members[q].end(), k) != members[q].end()) continue;
+            if (!shared) {
+                fresh.pop_back();
+                used.push_back(k);
+            }
+            members[q].push_back(k);
+        }
+    }
+
+    os << "Name: Synthetic-" << g.courses << "-" << g.seed << "\n"
+       << "Courses: " << g.courses << "\n"
+       << "Rooms: " << g.rooms << "\n"
+       << "Days: " << g.days << "\n"
+       << "Periods_per_day: " << g.periods_per_day << "\n"
+       << "Curricula: " << g.curricula << "\n"
+       << "Constraints: " << constraints << "\n\n";
+
+    os << "COURSES:\n";
+    for (c = 0; c < g.courses; c++) {
+        unsigned min_working_days = rng.Between(1, min(lectures[c], g.days));
+        unsigned students = max(5u, capacity[rng.Below(g.rooms)] - rng.Between(0, 9));
+        char teacher[32];
+        snprintf(teacher, sizeof teacher, "t%04u", unsigned(rng.Below(teachers)));
+        os << course_name(c) << " " << teacher << " " << lectures[c] << " " << min_working_days << " " << students << "\n";
+    }
+
+    os << "\nROOMS:\n";
+    for (r = 0; r < g.rooms; r++) os << "r" << r << "\t" << capacity[r] << "\n";
+
+    os << "\nCURRICULA:\n";
+    for (q = 0; q < g.curricula; q++) {
+        snprintf(name, sizeof name, "q%04u", q);
+        os << name << "  " << members[q].size();
+        for (i = 0; i < members[q].size(); i++) os << " " << course_name(members[q][i]);
+        os << "\n";
+    }
+
+    os << "\nUNAVAILABILITY_CONSTRAINTS:\n";
+    for (c = 0; c < g.courses; c++)
+        for (unsigned up : unavailable[c])
+            os << course_name(c) << " " << up / g.periods_per_day << " " << up % g.periods_per_day << "\n";
+
+    os << "\nEND.\n";
+}
+
+#endif
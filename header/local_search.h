@@ -0,0 +1,229 @@
+#ifndef LOCAL_SEARCH_H
+#define LOCAL_SEARCH_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+#include "faculty.h"
+#include "cost_engine.h"
+#include "rng.h"
+
+using namespace std;
+
+struct LocalSearchParameters {
+    unsigned moves = 0;     // move budget per individual, 0 disables local search
+    double seconds = 0;     // time budget per individual, 0 = only the move budget
+    double temperature = 0; // initial simulated annealing temperature, 0 = hill climbing
+};
+
+// Improvement stage of the memetic mode. It works directly on the timetable held
+// by a CostEngine with four neighbourhoods: move a lecture, swap two lectures,
+// change or swap rooms within a period, and Kempe-chain swaps between two periods
+// along the conflict graph. Every move is scored incrementally by the engine and
+// rejected if it adds hard violations.
+class LocalSearch {
+    private:
+        struct Lecture {
+            unsigned course, period;
+        };
+
+        const Faculty& in;
+        CostEngine& engine;
+        vector<Lecture> lectures; // scheduled lectures, for uniform sampling
+        // entries of lectures changed by the pending move, applied if it is accepted
+        unsigned pending, pending_index[2], pending_period[2];
+        // Kempe chain scratch data
+        vector<unsigned> side[2];
+        vector<bool> in_chain[2];
+        vector<unsigned> queue;
+        vector<Lecture> chain;
+        vector<unsigned> chain_rooms;
+
+        void CollectLectures() {
+            lectures.clear();
+            for (unsigned p = 0; p < in.Periods(); p++)
+                for (unsigned i = 0; i < engine.PeriodCoursesNo(p); i++)
+                    lectures.push_back({engine.PeriodCourses(p, i), p});
+        }
+
+        void Pending(unsigned i, unsigned period) {
+            pending_index[pending] = i;
+            pending_period[pending] = period;
+            pending++;
+        }
+
+        // Free room in period p that best fits course c, or 0 if all are taken: the
+        // smallest free room with enough seats, else the largest free room (the
+        // lowest-numbered one among rooms of equal capacity)
+        unsigned BestFreeRoom(unsigned c, unsigned p) const {
+            const unsigned* order = in.RoomsByCapacity();
+            unsigned students = in.Students(c), n = in.Rooms(), i, best = 0;
+            i = lower_bound(order, order + n, students, [this](unsigned r, unsigned s) { return in.Capacity(r) < s; }) - order;
+            for (unsigned j = i; j < n; j++)
+                if (engine.RoomLectures(order[j], p) == 0) return order[j];
+            while (i-- > 0) {
+                unsigned r = order[i];
+                if (engine.RoomLectures(r, p) != 0) continue;
+                if (best != 0 && in.Capacity(r) != in.Capacity(best)) break;
+                best = r;
+            }
+            return best;
+        }
+
+        // Move of lecture i to a random period and room
+        bool MoveLecture(unsigned i, Rng& rng, int& delta) {
+            Lecture l = lectures[i];
+            unsigned q = rng.Below(in.Periods());
+            unsigned r = rng.Between(1, in.Rooms());
+            if (q == l.period || engine(l.course, q) != 0) return false;
+            delta = engine.MoveLecture(l.course, l.period, q, r);
+            Pending(i, q);
+            return true;
+        }
+
+        // Swap of lecture i with a random lecture in another period
+        bool SwapLectures(unsigned i, Rng& rng, int& delta) {
+            unsigned j = rng.Below(lectures.size());
+            Lecture a = lectures[i], b = lectures[j];
+            if (a.period == b.period || a.course == b.course) return false;
+            if (engine(a.course, b.period) != 0 || engine(b.course, a.period) != 0) return false;
+            delta = engine.SwapLectures(a.course, a.period, b.course, b.period);
+            Pending(i, b.period);
+            Pending(j, a.period);
+            return true;
+        }
+
+        // Lecture i to a random room of the same period, swapping with its occupant if any
+        bool ChangeRoom(unsigned i, Rng& rng, int& delta) {
+            Lecture l = lectures[i];
+            unsigned r = rng.Between(1, in.Rooms());
+            if (r == engine(l.course, l.period)) return false;
+            for (unsigned k = 0; k < engine.PeriodCoursesNo(l.period); k++) {
+                unsigned c2 = engine.PeriodCourses(l.period, k);
+                if (engine(c2, l.period) == r) {
+                    delta = engine.SwapRooms(l.course, c2, l.period);
+                    return true;
+                }
+            }
+            delta = engine.MoveLecture(l.course, l.period, l.period, r);
+            return true;
+        }
+
+        // Kempe chain from lecture i between its period and a random other one: the
+        // connected component of the conflict graph over the lectures of the two
+        // periods changes side. Lectures keep their room when it is free.
+        bool KempeChain(unsigned i, Rng& rng, int& delta) {
+            unsigned p[2] = {lectures[i].period, (unsigned)rng.Below(in.Periods())};
+            unsigned s, k, j;
+            if (p[0] == p[1]) return false;
+
+            for (s = 0; s < 2; s++) {
+                side[s].assign(engine.PeriodCoursesNo(p[s]), 0);
+                for (k = 0; k < side[s].size(); k++) side[s][k] = engine.PeriodCourses(p[s], k);
+                in_chain[s].assign(side[s].size(), false);
+            }
+
+            // Breadth-first search; queue entries are side * size_of_side_0 + position
+            queue.clear();
+            for (k = 0; k < side[0].size(); k++) {
+                if (side[0][k] == lectures[i].course) {
+                    in_chain[0][k] = true;
+                    queue.push_back(k);
+                }
+            }
+            for (j = 0; j < queue.size(); j++) {
+                unsigned from = queue[j] >= side[0].size(), pos = from ? queue[j] - side[0].size() : queue[j];
+                unsigned c = side[from][pos], to = 1 - from;
+                for (k = 0; k < side[to].size(); k++) {
+                    if (!in_chain[to][k] && (side[to][k] == c || in.Conflict(c, side[to][k]))) {
+                        in_chain[to][k] = true;
+                        queue.push_back(to * side[0].size() + k);
+                    }
+                }
+            }
+
+            chain.clear();
+            chain_rooms.clear();
+            for (s = 0; s < 2; s++) {
+                for (k = 0; k < side[s].size(); k++) {
+                    if (in_chain[s][k]) {
+                        chain.push_back({side[s][k], s});
+                        chain_rooms.push_back(engine(side[s][k], p[s]));
+                    }
+                }
+            }
+
+            engine.BeginMove();
+            for (k = 0; k < chain.size(); k++)
+                engine.Unassign(chain[k].course, p[chain[k].period]);
+            for (k = 0; k < chain.size(); k++) {
+                unsigned to = p[1 - chain[k].period], r = chain_rooms[k];
+                if (engine.RoomLectures(r, to) != 0) r = BestFreeRoom(chain[k].course, to);
+                if (r == 0) r = chain_rooms[k];
+                engine.Assign(chain[k].course, to, r);
+            }
+            delta = engine.Delta();
+            return true;
+        }
+
+    public:
+        unsigned long moves = 0, accepted = 0;
+
+        // Scratch data is sized for the largest timetable without hard violations
+        // (at most Rooms() lectures per period), so moves do not allocate
+        LocalSearch(const Faculty& f, CostEngine& e) : in(f), engine(e), pending(0) {
+            lectures.reserve(in.Events());
+            for (unsigned s = 0; s < 2; s++) {
+                side[s].reserve(in.Rooms());
+                in_chain[s].reserve(in.Rooms());
+            }
+            queue.reserve(2 * in.Rooms());
+            chain.reserve(2 * in.Rooms());
+            chain_rooms.reserve(2 * in.Rooms());
+        }
+
+        // Improve the timetable in the engine; returns the final Cost()
+        int Run(const LocalSearchParameters& params, Rng& rng) {
+            auto start = chrono::steady_clock::now();
+            double temperature = params.temperature;
+            double cooling = params.moves > 0 ? pow(0.01, 1.0 / params.moves) : 1.0;
+
+            CollectLectures();
+            if (lectures.empty() || in.Periods() < 2) return engine.Cost();
+
+            for (unsigned m = 0; m < params.moves; m++) {
+                if (params.seconds > 0 && m % 64 == 0 &&
+                    chrono::duration<double>(chrono::steady_clock::now() - start).count() > params.seconds)
+                    break;
+
+                unsigned i = rng.Below(lectures.size());
+                unsigned kind = rng.Between(0, 3);
+                int delta = 0;
+                bool applied;
+
+                pending = 0;
+                if (kind == 0) applied = MoveLecture(i, rng, delta);
+                else if (kind == 1) applied = SwapLectures(i, rng, delta);
+                else if (kind == 2) applied = ChangeRoom(i, rng, delta);
+                else applied = KempeChain(i, rng, delta);
+                temperature *= cooling;
+                if (!applied) continue;
+                moves++;
+
+                bool accept = engine.ViolationsDelta() <= 0 &&
+                    (delta <= 0 || (temperature > 0 && rng.Uniform() < exp(-delta / temperature)));
+                if (accept) {
+                    engine.Commit();
+                    accepted++;
+                    for (unsigned k = 0; k < pending; k++) lectures[pending_index[k]].period = pending_period[k];
+                    if (kind == 3) CollectLectures();
+                } else {
+                    engine.Rollback();
+                }
+            }
+            return engine.Cost();
+        }
+};
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef MAILBOX_H
+#define MAILBOX_H
+
+#include <mutex>
+#include <vector>
+
+using namespace std;
+
+// Inbox of one island. Senders append under a short lock; the owner only
+// try-locks when collecting, so it never waits on a sender and simply picks
+// the messages up on its next attempt.
+template <typename T>
+class Mailbox {
+    private:
+        mutex m;
+        vector<T> messages;
+    public:
+        void Post(const T* first, const T* last) {
+            lock_guard<mutex> lock(m);
+            messages.insert(messages.end(), first, last);
+        }
+
+        // Move all pending messages to out; returns false if the box was busy
+        bool TryCollect(vector<T>& out) {
+            unique_lock<mutex> lock(m, try_to_lock);
+            if (!lock.owns_lock()) return false;
+            out.swap(messages);
+            messages.clear();
+            return true;
+        }
+};
+
+#endif
@@ -0,0 +1,132 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+// Read-only memory mapping of a whole file
+class MappedFile {
+    private:
+        const char* data;
+        size_t size;
+    public:
+        MappedFile(const string& file_name) : data(nullptr), size(0) {
+            int fd = open(file_name.c_str(), O_RDONLY);
+            if (fd < 0) return;
+            struct stat st;
+            if (fstat(fd, &st) == 0 && st.st_size > 0) {
+                void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (p != MAP_FAILED) {
+                    data = static_cast<const char*>(p);
+                    size = st.st_size;
+                }
+            }
+            close(fd);
+        }
+        ~MappedFile() { if (data) munmap(const_cast<char*>(data), size); }
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        bool Fail() const { return data == nullptr; }
+        const char* Data() const { return data; }
+        size_t Size() const { return size; }
+};
+
+// Whitespace-separated tokens of a buffer, returned as views into it
+class Tokenizer {
+    private:
+        const char* pos;
+        const char* end;
+
+        static bool Space(char ch) { return ch == ' ' || ch == '\n' || ch == '\t' || ch == '\r' || ch == '\f' || ch == '\v'; }
+    public:
+        Tokenizer(const char* begin, size_t size) : pos(begin), end(begin + size) {}
+
+        string_view Next() {
+            while (pos < end && Space(*pos)) pos++;
+            const char* start = pos;
+            while (pos < end && !Space(*pos)) pos++;
+            return string_view(start, pos - start);
+        }
+
+        unsigned NextUnsigned() {
+            string_view token = Next();
+            unsigned value = 0;
+            for (char ch : token) value = value * 10 + (ch - '0');
+            return value;
+        }
+
+        void Skip() { Next(); }
+};
+
+// Sequential reader of the binary instance format; reads past the end set Fail()
+class BinaryReader {
+    private:
+        const char* data;
+        size_t size, pos;
+        bool failed;
+
+        bool Take(size_t n) {
+            if (failed || n > size - pos) { failed = true; return false; }
+            pos += n;
+            return true;
+        }
+    public:
+        BinaryReader(const char* begin, size_t n) : data(begin), size(n), pos(0), failed(false) {}
+
+        bool Fail() const { return failed; }
+        size_t Remaining() const { return size - pos; }
+
+        template <typename T>
+        T Read() {
+            T value{};
+            if (Take(sizeof(T))) memcpy(&value, data + pos - sizeof(T), sizeof(T));
+            return value;
+        }
+
+        template <typename T>
+        void ReadArray(T* out, size_t n) {
+            if (n > (size - pos) / sizeof(T)) { failed = true; return; }
+            if (n > 0 && Take(n * sizeof(T))) memcpy(out, data + pos - n * sizeof(T), n * sizeof(T));
+        }
+
+        string ReadString() {
+            uint32_t n = Read<uint32_t>();
+            if (!Take(n)) return string();
+            return string(data + pos - n, n);
+        }
+};
+
+// Writes what BinaryReader reads: native-endian values, arrays and length-prefixed strings
+class BinaryWriter {
+    private:
+        ostream& os;
+    public:
+        BinaryWriter(ostream& s) : os(s) {}
+
+        template <typename T>
+        void Write(const T& value) { os.write(reinterpret_cast<const char*>(&value), sizeof(T)); }
+
+        template <typename T>
+        void WriteArray(const T* values, size_t n) { os.write(reinterpret_cast<const char*>(values), n * sizeof(T)); }
+
+        template <typename T>
+        void WriteArray(const vector<T>& values) { WriteArray(values.data(), values.size()); }
+
+        void WriteString(const string& s) {
+            Write<uint32_t>(s.size());
+            os.write(s.data(), s.size());
+        }
+};
+
+#endif
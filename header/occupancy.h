@@ -0,0 +1,102 @@
+#ifndef OCCUPANCY_H
+#define OCCUPANCY_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "faculty.h"
+#include "telemetry.h"
+
+using namespace std;
+
+// Bit-packed state of the greedy decoder: which rooms are still free in each
+// period and which periods each course can no longer take, because the course
+// itself or one of its neighbours in the conflict graph (same curriculum or same
+// teacher) is already there. Rooms 1 .. Rooms() are stored in bits 0 .. Rooms() - 1.
+class Occupancy {
+    private:
+        const Faculty& in;
+        unsigned period_words, room_words;
+        vector<uint64_t> free_rooms;      // (periods X room_words)
+        vector<uint64_t> blocked;         // (courses X period_words)
+
+        static unsigned LowestBit(uint64_t w) { return __builtin_ctzll(w); }
+
+        unsigned FirstFreeRoom(unsigned p) const {
+            const uint64_t* rooms = free_rooms.data() + p * room_words;
+            for (unsigned w = 0; w < room_words; w++)
+                if (rooms[w] != 0)
+                    return w * 64 + LowestBit(rooms[w]) + 1;
+            return 0;
+        }
+
+    public:
+        mutable Counters counters; // first-fit probes and rejections (INSTRUMENT only)
+
+        Occupancy(const Faculty& f) : in(f), period_words(f.PeriodWords()), room_words((f.Rooms() + 63) / 64),
+            free_rooms(f.Periods() * room_words), blocked(f.Courses() * period_words) {
+            Clear();
+        }
+
+        void Clear() {
+            unsigned p, w, r = in.Rooms();
+            for (p = 0; p < in.Periods(); p++) {
+                for (w = 0; w < room_words; w++) {
+                    unsigned bits = r > 64 * (w + 1) ? 64 : r - 64 * w;
+                    free_rooms[p * room_words + w] = bits == 64 ? ~uint64_t(0) : (uint64_t(1) << bits) - 1;
+                }
+            }
+            fill(blocked.begin(), blocked.end(), 0);
+        }
+
+        // Lowest feasible period and, within it, lowest free room for event e;
+        // the same cell the cell-by-cell scan in period-major order would find
+        bool FirstFit(unsigned e, unsigned& period, unsigned& room) const {
+            const Event& ev = in.EventVector(e);
+            const uint64_t* available = in.AvailabilityBits(ev.course);
+            const uint64_t* busy = blocked.data() + ev.course * period_words;
+            for (unsigned w = 0; w < period_words; w++) {
+                uint64_t candidates = available[w] & ~busy[w];
+                INSTRUMENT_COUNT(counters.conflicting += __builtin_popcountll(available[w] & busy[w]));
+                INSTRUMENT_COUNT(counters.unavailable += min(64u, in.Periods() - 64 * w) - __builtin_popcountll(available[w]));
+                while (candidates) {
+                    unsigned p = w * 64 + LowestBit(candidates);
+                    unsigned r = FirstFreeRoom(p);
+                    INSTRUMENT_COUNT(counters.probes++);
+                    if (r != 0) {
+                        period = p;
+                        room = r;
+                        return true;
+                    }
+                    INSTRUMENT_COUNT(counters.rooms_full++);
+                    candidates &= candidates - 1;
+                }
+            }
+            INSTRUMENT_COUNT(counters.unplaced++);
+            return false;
+        }
+
+        // The whole state as StateWords() words, for decoder checkpoints
+        size_t StateWords() const { return free_rooms.size() + blocked.size(); }
+
+        void Save(uint64_t* state) const {
+            copy(free_rooms.begin(), free_rooms.end(), state);
+            copy(blocked.begin(), blocked.end(), state + free_rooms.size());
+        }
+
+        void Restore(const uint64_t* state) {
+            copy(state, state + free_rooms.size(), free_rooms.begin());
+            copy(state + free_rooms.size(), state + StateWords(), blocked.begin());
+        }
+
+        void Assign(unsigned e, unsigned p, unsigned r) {
+            const Event& ev = in.EventVector(e);
+            uint64_t bit = uint64_t(1) << (p % 64);
+            free_rooms[p * room_words + (r - 1) / 64] &= ~(uint64_t(1) << ((r - 1) % 64));
+            blocked[ev.course * period_words + p / 64] |= bit;
+            for (const unsigned* n = in.ConflictsBegin(ev.course); n != in.ConflictsEnd(ev.course); ++n)
+                blocked[*n * period_words + p / 64] |= bit;
+        }
+};
+
+#endif
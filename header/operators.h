@@ -0,0 +1,159 @@
+#ifndef OPERATORS_H
+#define OPERATORS_H
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "rng.h"
+
+using namespace std;
+
+// Permutation operators over chromosomes holding each of the genes 0 .. n-1 once.
+// They run in O(n) and, once the scratch buffers and the child have grown to n
+// genes, never allocate.
+
+enum class CrossoverType { Order, PartiallyMapped, Cycle, Position };
+
+// Reusable buffers of one worker. A gene is marked when mark[gene] == stamp, so
+// clearing all marks is a single increment.
+class OperatorScratch {
+    private:
+        vector<unsigned> mark;
+        unsigned stamp = 0;
+    public:
+        vector<int> position; // position of each gene in a parent
+
+        void Reset(size_t n) {
+            if (mark.size() != n) {
+                mark.assign(n, 0);
+                position.resize(n);
+                stamp = 0;
+            }
+            if (++stamp == 0) {
+                fill(mark.begin(), mark.end(), 0);
+                stamp = 1;
+            }
+        }
+        bool Marked(int gene) const { return mark[gene] == stamp; }
+        void Mark(int gene) { mark[gene] = stamp; }
+};
+
+// Random cut points start <= end
+inline void random_segment(int size, Rng& rng, int& start, int& end) {
+    start = rng.Below(size);
+    end = rng.Below(size);
+    if (start > end) swap(start, end);
+}
+
+// Child positions not marked keep -1; fill them with the unmarked genes in the order of p2
+inline void fill_in_order(const vector<int>& p2, vector<int>& child, OperatorScratch& scratch) {
+    int size = p2.size(), j = 0;
+    for (int i = 0; i < size; ++i) {
+        if (child[i] == -1) {
+            while (scratch.Marked(p2[j])) j++;
+            child[i] = p2[j++];
+        }
+    }
+}
+
+// OX: a random segment of p1 in place, the other genes in the order of p2
+inline void order_crossover(const vector<int>& p1, const vector<int>& p2, vector<int>& child, Rng& rng, OperatorScratch& scratch) {
+    int size = p1.size(), start, end;
+    child.assign(size, -1);
+    scratch.Reset(size);
+    random_segment(size, rng, start, end);
+
+    for (int i = start; i <= end; ++i) {
+        child[i] = p1[i];
+        scratch.Mark(p1[i]);
+    }
+    fill_in_order(p2, child, scratch);
+}
+
+// PMX: a random segment of p1 in place, the other positions from p2; a gene of p2
+// already in the segment is replaced by following the segment's mapping p1 -> p2
+inline void pmx_crossover(const vector<int>& p1, const vector<int>& p2, vector<int>& child, Rng& rng, OperatorScratch& scratch) {
+    int size = p1.size(), start, end;
+    child.resize(size);
+    scratch.Reset(size);
+    random_segment(size, rng, start, end);
+
+    for (int i = start; i <= end; ++i) {
+        child[i] = p1[i];
+        scratch.Mark(p1[i]);
+        scratch.position[p1[i]] = i;
+    }
+    for (int i = 0; i < size; ++i) {
+        if (i == start) i = end + 1;
+        if (i >= size) break;
+        int gene = p2[i];
+        while (scratch.Marked(gene)) gene = p2[scratch.position[gene]];
+        child[i] = gene;
+    }
+}
+
+// CX: the cycles of positions between p1 and p2, taken alternately from p1 and p2
+inline void cycle_crossover(const vector<int>& p1, const vector<int>& p2, vector<int>& child, OperatorScratch& scratch) {
+    int size = p1.size();
+    bool from_p1 = true;
+    child.assign(size, -1);
+    scratch.Reset(size);
+    for (int i = 0; i < size; ++i) scratch.position[p1[i]] = i;
+
+    for (int i = 0; i < size; ++i) {
+        if (child[i] != -1) continue;
+        const vector<int>& parent = from_p1 ? p1 : p2;
+        for (int j = i; child[j] == -1; j = scratch.position[p2[j]]) child[j] = parent[j];
+        from_p1 = !from_p1;
+    }
+}
+
+// Position-based: genes of p1 at random positions (each with probability 1/2)
+// stay in place, the other genes in the order of p2
+inline void position_crossover(const vector<int>& p1, const vector<int>& p2, vector<int>& child, Rng& rng, OperatorScratch& scratch) {
+    int size = p1.size();
+    uint64_t bits = 0;
+    child.assign(size, -1);
+    scratch.Reset(size);
+
+    for (int i = 0; i < size; ++i) {
+        if (i % 64 == 0) bits = rng();
+        if (bits & 1) {
+            child[i] = p1[i];
+            scratch.Mark(p1[i]);
+        }
+        bits >>= 1;
+    }
+    fill_in_order(p2, child, scratch);
+}
+
+inline void crossover(CrossoverType type, const vector<int>& p1, const vector<int>& p2, vector<int>& child, Rng& rng, OperatorScratch& scratch) {
+    switch (type) {
+        case CrossoverType::Order: order_crossover(p1, p2, child, rng, scratch); break;
+        case CrossoverType::PartiallyMapped: pmx_crossover(p1, p2, child, rng, scratch); break;
+        case CrossoverType::Cycle: cycle_crossover(p1, p2, child, scratch); break;
+        case CrossoverType::Position: position_crossover(p1, p2, child, rng, scratch); break;
+    }
+}
+
+// Every gene is swapped with a random position with probability rate. The genes to
+// swap are found by drawing the geometric gaps between them, so the cost is one
+// random number per swap instead of one per gene.
+inline void swap_mutation(vector<int>& chromosome, Rng& rng, double rate) {
+    size_t size = chromosome.size();
+    if (size == 0 || rate <= 0) return;
+    double log_keep = log1p(-min(rate, 1.0));
+
+    for (size_t i = 0; ; ++i) {
+        if (rate < 1) {
+            double gap = floor(log1p(-rng.Uniform()) / log_keep);
+            if (gap >= size - i) break;
+            i += size_t(gap);
+        } else if (i >= size) {
+            break;
+        }
+        swap(chromosome[i], chromosome[rng.Below(size)]);
+    }
+}
+
+#endif
@@ -0,0 +1,97 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <cstdint>
+#include <iterator>
+#include <utility>
+
+using namespace std;
+
+// Random number generator of the solver: xoshiro256** seeded through splitmix64.
+// Stream k of a seed starts 2^128 * k outputs further down the sequence, so the
+// streams of different workers never overlap. Also usable as a standard uniform
+// random bit generator.
+class Rng {
+    private:
+        uint64_t s[4];
+
+        static uint64_t Rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+        static uint64_t SplitMix(uint64_t& x) {
+            uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            return z ^ (z >> 31);
+        }
+
+    public:
+        typedef uint64_t result_type;
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return ~uint64_t(0); }
+
+        explicit Rng(uint64_t seed = 1, unsigned stream = 0) { Seed(seed, stream); }
+
+        void Seed(uint64_t seed, unsigned stream = 0) {
+            for (int i = 0; i < 4; i++) s[i] = SplitMix(seed);
+            for (unsigned k = 0; k < stream; k++) Jump();
+        }
+
+        result_type operator()() {
+            uint64_t result = Rotl(s[1] * 5, 7) * 9, t = s[1] << 17;
+            s[2] ^= s[0];
+            s[3] ^= s[1];
+            s[1] ^= s[2];
+            s[0] ^= s[3];
+            s[2] ^= t;
+            s[3] = Rotl(s[3], 45);
+            return result;
+        }
+
+        // Raw generator state, for checkpoints
+        void SaveState(uint64_t state[4]) const { for (int i = 0; i < 4; i++) state[i] = s[i]; }
+        void LoadState(const uint64_t state[4]) { for (int i = 0; i < 4; i++) s[i] = state[i]; }
+
+        // Advance by 2^128 outputs
+        void Jump() {
+            static const uint64_t JUMP[] = {0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL};
+            uint64_t t[4] = {0, 0, 0, 0};
+            for (uint64_t jump : JUMP) {
+                for (int b = 0; b < 64; b++) {
+                    if (jump & uint64_t(1) << b)
+                        for (int i = 0; i < 4; i++) t[i] ^= s[i];
+                    (*this)();
+                }
+            }
+            for (int i = 0; i < 4; i++) s[i] = t[i];
+        }
+
+        // Unbiased integer in [0, n), n > 0 (Lemire's multiply and reject)
+        uint64_t Below(uint64_t n) {
+            unsigned __int128 m = (unsigned __int128)(*this)() * n;
+            uint64_t low = uint64_t(m);
+            if (low < n) {
+                uint64_t threshold = -n % n;
+                while (low < threshold) {
+                    m = (unsigned __int128)(*this)() * n;
+                    low = uint64_t(m);
+                }
+            }
+            return uint64_t(m >> 64);
+        }
+
+        // Unbiased integer in [low, high]
+        unsigned Between(unsigned low, unsigned high) { return low + Below(uint64_t(high) - low + 1); }
+
+        // Uniform double in [0, 1)
+        double Uniform() { return ((*this)() >> 11) * 0x1.0p-53; }
+
+        bool Chance(double p) { return Uniform() < p; }
+
+        template <typename It>
+        void Shuffle(It first, It last) {
+            for (auto n = distance(first, last); n > 1; n--)
+                swap(first[n - 1], first[Below(n)]);
+        }
+};
+
+#endif
@@ -14,6 +14,8 @@ class Room {
         string name;
         unsigned capacity;
     public:
+        Room() : capacity(0) {}
+        Room(const string& n, unsigned c) : name(n), capacity(c) {}
         const string& Name() const { return name; }
         unsigned Capacity() const { return capacity; }
 };
@@ -0,0 +1,129 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <chrono>
+#include <fstream>
+#include <string>
+
+using namespace std;
+
+// Hot-path instrumentation, compiled in with -DINSTRUMENT. Each worker (and its
+// decoder) owns its counters, so counting needs no synchronisation; run_ga()
+// collects them after every generation. Without INSTRUMENT the macros expand to
+// nothing and the counters stay zero.
+
+enum Phase { PHASE_SELECTION, PHASE_CROSSOVER, PHASE_MUTATION, PHASE_DECODE, PHASE_SCORE, PHASE_LOCAL_SEARCH, PHASES };
+
+static const char* const PHASE_NAMES[PHASES] = {"selection", "crossover", "mutation", "decode", "score", "local_search"};
+
+struct Counters {
+    double seconds[PHASES] = {};
+    unsigned long calls[PHASES] = {};
+    // first-fit decoder
+    unsigned long probes = 0;      // periods searched for a free room
+    unsigned long unavailable = 0; // periods skipped as unavailable to the course
+    unsigned long conflicting = 0; // periods skipped as taken by the course or a conflicting one
+    unsigned long rooms_full = 0;  // probes that found no free room
+    unsigned long unplaced = 0;    // events left without a cell
+
+    Counters& operator+=(const Counters& other) {
+        for (int p = 0; p < PHASES; p++) {
+            seconds[p] += other.seconds[p];
+            calls[p] += other.calls[p];
+        }
+        probes += other.probes;
+        unavailable += other.unavailable;
+        conflicting += other.conflicting;
+        rooms_full += other.rooms_full;
+        unplaced += other.unplaced;
+        return *this;
+    }
+};
+
+#ifdef INSTRUMENT
+// Adds the lifetime of the enclosing scope to a phase
+class PhaseTimer {
+    private:
+        Counters& counters;
+        Phase phase;
+        chrono::steady_clock::time_point start;
+    public:
+        PhaseTimer(Counters& c, Phase p) : counters(c), phase(p), start(chrono::steady_clock::now()) {}
+        ~PhaseTimer() {
+            counters.seconds[phase] += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            counters.calls[phase]++;
+        }
+};
+
+#define INSTRUMENT_JOIN2(a, b) a##b
+#define INSTRUMENT_JOIN(a, b) INSTRUMENT_JOIN2(a, b)
+#define INSTRUMENT_PHASE(counters, phase) PhaseTimer INSTRUMENT_JOIN(phase_timer_, __LINE__)(counters, phase)
+#define INSTRUMENT_COUNT(statement) statement
+#else
+#define INSTRUMENT_PHASE(counters, phase) ((void)0)
+#define INSTRUMENT_COUNT(statement) ((void)0)
+#endif
+
+// One line of telemetry, written after every generation
+struct GenerationRecord {
+    int generation = 0;
+    double seconds = 0;           // elapsed since the start of the run
+    int best = 0;
+    double crossover_rate = 0, mutation_rate = 0; // used for this generation
+    double mean = 0, deviation = 0; // of the population's fitness
+    unsigned distinct = 0;        // distinct fitness values in the population
+    unsigned long evaluations = 0; // in this generation
+    double evaluations_per_second = 0;
+    Counters counters;            // of this generation
+};
+
+// Writes GenerationRecords as CSV, or as a JSON array if the file name ends in .json
+class TelemetryWriter {
+    private:
+        ofstream os;
+        bool json, first, closed;
+    public:
+        TelemetryWriter(const string& file_name) : os(file_name.c_str()), first(true), closed(false) {
+            json = file_name.size() >= 5 && file_name.compare(file_name.size() - 5, 5, ".json") == 0;
+            if (json) {
+                os << "[";
+                return;
+            }
+            os << "generation,seconds,best,mean,deviation,distinct,evaluations,evaluations_per_second,crossover_rate,mutation_rate";
+            for (int p = 0; p < PHASES; p++) os << ',' << PHASE_NAMES[p] << "_seconds";
+            os << ",probes,unavailable,conflicting,rooms_full,unplaced\n";
+        }
+
+        ~TelemetryWriter() { Close(); }
+
+        // Finish the file and flush it; false if anything written so far was lost
+        bool Close() {
+            if (!closed && json) os << "\n]\n";
+            closed = true;
+            return !os.flush().fail();
+        }
+
+        bool Fail() const { return os.fail(); }
+
+        void Write(const GenerationRecord& r) {
+            const Counters& c = r.counters;
+            if (json) {
+                os << (first ? "\n  " : ",\n  ") << "{\"generation\": " << r.generation << ", \"seconds\": " << r.seconds
+                   << ", \"best\": " << r.best << ", \"mean\": " << r.mean << ", \"deviation\": " << r.deviation
+                   << ", \"distinct\": " << r.distinct << ", \"evaluations\": " << r.evaluations
+                   << ", \"evaluations_per_second\": " << r.evaluations_per_second << ", \"crossover_rate\": " << r.crossover_rate
+                   << ", \"mutation_rate\": " << r.mutation_rate << ", \"phase_seconds\": {";
+                for (int p = 0; p < PHASES; p++) os << (p ? ", \"" : "\"") << PHASE_NAMES[p] << "\": " << c.seconds[p];
+                os << "}, \"probes\": " << c.probes << ", \"unavailable\": " << c.unavailable << ", \"conflicting\": " << c.conflicting
+                   << ", \"rooms_full\": " << c.rooms_full << ", \"unplaced\": " << c.unplaced << "}";
+            } else {
+                os << r.generation << ',' << r.seconds << ',' << r.best << ',' << r.mean << ',' << r.deviation << ','
+                   << r.distinct << ',' << r.evaluations << ',' << r.evaluations_per_second << ',' << r.crossover_rate << ',' << r.mutation_rate;
+                for (int p = 0; p < PHASES; p++) os << ',' << c.seconds[p];
+                os << ',' << c.probes << ',' << c.unavailable << ',' << c.conflicting << ',' << c.rooms_full << ',' << c.unplaced << '\n';
+            }
+            first = false;
+        }
+};
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+using namespace std;
+
+// Fixed set of workers that run the same job together. Worker 0 is the calling
+// thread, so a pool of size 1 runs everything inline without any thread.
+class ThreadPool {
+    private:
+        vector<thread> threads;
+        mutex m;
+        condition_variable start_cv, done_cv;
+        // job of the current round: a pointer to the caller's callable and a function
+        // that calls it, so starting a round never allocates
+        void* job;
+        void (*call)(void*, unsigned);
+        unsigned round, pending;
+        bool stop;
+
+        void Loop(unsigned worker) {
+            unsigned seen = 0;
+            for (;;) {
+                {
+                    unique_lock<mutex> lock(m);
+                    start_cv.wait(lock, [&] { return stop || round != seen; });
+                    if (stop) return;
+                    seen = round;
+                }
+                call(job, worker);
+                {
+                    lock_guard<mutex> lock(m);
+                    if (--pending == 0) done_cv.notify_one();
+                }
+            }
+        }
+
+    public:
+        ThreadPool(unsigned workers) : job(nullptr), call(nullptr), round(0), pending(0), stop(false) {
+            for (unsigned w = 1; w < workers; w++)
+                threads.emplace_back(&ThreadPool::Loop, this, w);
+        }
+
+        ~ThreadPool() {
+            {
+                lock_guard<mutex> lock(m);
+                stop = true;
+            }
+            start_cv.notify_all();
+            for (auto& t : threads) t.join();
+        }
+
+        unsigned Size() const { return threads.size() + 1; }
+
+        // Run f(worker) once on every worker and wait for all of them
+        template <typename F>
+        void Run(F&& f) {
+            {
+                lock_guard<mutex> lock(m);
+                job = (void*)&f;
+                call = [](void* g, unsigned worker) { (*static_cast<typename remove_reference<F>::type*>(g))(worker); };
+                pending = threads.size();
+                round++;
+            }
+            start_cv.notify_all();
+            f(0);
+            unique_lock<mutex> lock(m);
+            done_cv.wait(lock, [&] { return pending == 0; });
+        }
+};
+
+#endif
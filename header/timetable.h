@@ -1,47 +1,51 @@
 #ifndef TIMETABLE_H
 #define TIMETABLE_H
 
+#include <algorithm>
+#include <climits>
+#include <cstdint>
 #include <string>
+#include <unordered_set>
 #include <vector>
 #include "faculty.h"
 
 using namespace std;
 
+struct ScheduledLecture {
+    unsigned course, period, room;
+};
+
 class Timetable {
     private:
         const Faculty & in;  
         unsigned warnings;
-        vector<vector<unsigned> > tt;  // (courses X periods) timetable matrix
-        // redundant data
-        vector<vector<unsigned> > room_lectures; // number of lectures per room in the same period (should be 0 or 1)
-        vector<vector<unsigned> > curriculum_period_lectures; // number of lectures per curriculum in the same period (should be 0 or 1)
-        vector<vector<unsigned> > course_daily_lectures; // number of lectures per course per day
+        vector<ScheduledLecture> lectures; // the scheduled lectures, sorted by course and period
+        // redundant data, all of it O(courses + lectures): no courses X periods or rooms X periods grids
+        vector<unsigned> course_start; // lectures of course c are lectures[course_start[c] .. course_start[c + 1])
         vector<unsigned> working_days; // number of days of lecture per course
         vector<vector<unsigned> > used_rooms; // rooms used for each lecture on the course
     public:
-        Timetable(const Faculty & f, const string file_name) : in(f), tt(in.Courses(), vector<unsigned>(in.Periods(), 0)),
-            room_lectures(in.Rooms() + 1, vector<unsigned>(in.Periods())), 
-            curriculum_period_lectures(in.Curricula(), vector<unsigned>(in.Periods())),
-            course_daily_lectures(in.Courses(), vector<unsigned>(in.Days())), 
-            working_days(in.Courses()), used_rooms(in.Courses()) {
+        // A solution file that cannot be read ends the program, unless error is given:
+        // then the message goes to *error and the timetable is left empty
+        Timetable(const Faculty & f, const string file_name, string* error = nullptr)
+            : in(f), course_start(in.Courses() + 1), working_days(in.Courses()), used_rooms(in.Courses()) {
             unsigned day, period, p;
             int c, r;
             string course_name, room_name;
+            unordered_set<uint64_t> scheduled; // course * periods + period of every lecture read so far
             ifstream is(file_name.c_str());
 
             warnings = 0;
 
             if (is.fail()) {
+                if (error) {
+                    *error = "Output file does not exist!";
+                    return;
+                }
                 cerr << "Output file does not exist!" << endl;
                 exit(1);
             }
 
-            for (unsigned i = 0; i < tt.size(); i++) {
-                for (unsigned j = 0; j < tt[i].size(); j++) {
-                    tt[i][j] = 0;
-                }
-            }
-
             while (is >> course_name >> room_name >> day >> period) {
                 c = in.CourseIndex(course_name);
                 if (c == -1) {
@@ -67,81 +71,73 @@ class Timetable {
                     continue;
                 }
                 p = day * in.PeriodsPerDay() + period;
-                if (tt[c][p] != 0) {
+                if (!scheduled.insert(uint64_t(c) * in.Periods() + p).second) {
                     cerr << "WARNING: Course " << course_name << " already scheduled at period "
                          << p << " (entry skipped)" << endl;
                     warnings++;
                     continue;
                 }
-                tt[c][p] = r;
+                lectures.push_back({(unsigned)c, p, (unsigned)r});
             }
+            if (is.bad()) {
+                if (error) {
+                    *error = "Output file cannot be read!";
+                    lectures.clear();
+                    return;
+                }
+                cerr << "Output file cannot be read!" << endl;
+                exit(1);
+            }
+            sort(lectures.begin(), lectures.end(), [](const ScheduledLecture& a, const ScheduledLecture& b) {
+                return a.course < b.course || (a.course == b.course && a.period < b.period);
+            });
             UpdateRedundantData();
         }
 
-        // Inspect timetable
-        unsigned operator()(unsigned i, unsigned j) const { return tt[i][j]; }
-        unsigned& operator()(unsigned i, unsigned j) { return tt[i][j]; }
+        // Inspect timetable: room of course i at period j, 0 if none
+        unsigned operator()(unsigned i, unsigned j) const {
+            auto first = lectures.begin() + course_start[i], last = lectures.begin() + course_start[i + 1];
+            auto it = lower_bound(first, last, j, [](const ScheduledLecture& l, unsigned p) { return l.period < p; });
+            return it != last && it->period == j ? it->room : 0;
+        }
+        unsigned LecturesNo() const { return lectures.size(); }
+        const ScheduledLecture& Lecture(unsigned i) const { return lectures[i]; }
         // Inspect redundant data
-        unsigned RoomLectures(unsigned i, unsigned j) const { return room_lectures[i][j]; }
-        unsigned CurriculumPeriodLectures(unsigned i, unsigned j) const { return curriculum_period_lectures[i][j]; }
-        unsigned CourseDailyLectures(unsigned i, unsigned j) const { return course_daily_lectures[i][j]; }
+        unsigned CourseDailyLectures(unsigned i, unsigned j) const {
+            unsigned k, n = 0;
+            for (k = course_start[i]; k < course_start[i + 1]; k++)
+                if (lectures[k].period / in.PeriodsPerDay() == j)
+                    n++;
+            return n;
+        }
         unsigned WorkingDays(unsigned i) const { return working_days[i]; }
         unsigned UsedRoomsNo(unsigned i) const { return used_rooms[i].size(); }
         unsigned UsedRooms(unsigned i, unsigned j) const { return used_rooms[i][j]; }
         void InsertUsedRoom(unsigned i, unsigned j) { used_rooms[i].push_back(j); }
         unsigned Warnings() const { return warnings; }
+        // Rebuild the redundant data from the scheduled lectures, in O(courses + rooms + lectures)
         void UpdateRedundantData() {
-            unsigned p, c, r, d, g, gn, i;
-            for (r = 1; r < in.Rooms() + 1; r++)
-                for (p = 0; p < in.Periods(); p++)
-                    room_lectures[r][p] = 0;
-            gn = in.Curricula();
-            for (g = 0; g < gn; g++)
-                for (p = 0; p < in.Periods(); p++)
-                    curriculum_period_lectures[g][p] = 0;
-            for (c = 0; c < in.Courses(); c++) {
-                for (p = 0; p < in.Periods(); p++) {
-                    r = tt[c][p];
-                    if (r != 0)
-                        room_lectures[r][p]++;
-                }
-            }
-            for (c = 0; c < in.Courses(); c++) {
-                for (g = 0; g < in.Curricula(); g++) {
-                    if (in.CurriculumMember(c, g)) {
-                        for (p = 0; p < in.Periods(); p++) {
-                            if (tt[c][p] != 0) {
-                                curriculum_period_lectures[g][p]++;
-                            }
-                        }
-                    }
-                }
-            }
+            vector<unsigned> room_course(in.Rooms() + 1, UINT_MAX); // last course seen in each room
+            unsigned c, i, day;
+            fill(course_start.begin(), course_start.end(), 0);
             for (c = 0; c < in.Courses(); c++) {
                 working_days[c] = 0;
-                for (d = 0; d < in.Days(); d++) {
-                    course_daily_lectures[c][d] = 0;
-                    for (p = d * in.PeriodsPerDay(); p < (d + 1) * in.PeriodsPerDay(); p++) {
-                        if (tt[c][p] != 0)
-                            course_daily_lectures[c][d]++;
-                    }
-                    if (course_daily_lectures[c][d] >= 1)
-                        working_days[c]++;
-                }
+                used_rooms[c].clear();
             }
-            for (c = 0; c < in.Courses(); c++) {
-                for (p = 0; p < in.Periods(); p++) {
-                    r = tt[c][p];
-                    if (r != 0) {
-                        for (i = 0; i < used_rooms[c].size(); i++)
-                            if (used_rooms[c][i] == r)
-                                break;
-                        if (i == used_rooms[c].size()) {
-                            used_rooms[c].push_back(r);
-                        }
-                    }
+            for (i = 0; i < lectures.size(); i++) {
+                const ScheduledLecture& l = lectures[i];
+                course_start[l.course + 1]++;
+                // lectures of a course come in period order, so a new day starts whenever the day changes
+                day = l.period / in.PeriodsPerDay();
+                if (i == 0 || lectures[i - 1].course != l.course || lectures[i - 1].period / in.PeriodsPerDay() != day)
+                    working_days[l.course]++;
+                if (room_course[l.room] != l.course) {
+                    room_course[l.room] = l.course;
+                    used_rooms[l.course].push_back(l.room);
                 }
             }
+            for (c = 0; c < in.Courses(); c++)
+                course_start[c + 1] += course_start[c];
         }
 };
 
@@ -0,0 +1,279 @@
+#ifndef VALIDATOR_H
+#define VALIDATOR_H
+
+#include <algorithm>
+#include <climits>
+#include <iostream>
+#include <vector>
+#include "faculty.h"
+#include "cost_kernels.h"
+#include "timetable.h"
+
+using namespace std;
+
+// Costs of a timetable, unweighted as in the Validator output
+struct ValidationCosts {
+    unsigned lectures, conflicts, availability, room_occupation;
+    unsigned room_capacity, min_working_days, curriculum_compactness, room_stability;
+};
+
+// Every cost is computed once, in the constructor, in one pass over the
+// scheduled lectures grouped by period: conflicts are found through the
+// conflict lists of the courses met in the period, room and curriculum counts
+// come from per-period scratch counters, so validation takes
+// O(lectures + their conflict lists + courses + rooms) and no grid over the periods.
+class Validator {
+    private:
+        struct Cell {
+            unsigned first, second, period;
+            bool operator<(const Cell& o) const {
+                return first < o.first || (first == o.first && (second < o.second || (second == o.second && period < o.period)));
+            }
+            bool operator==(const Cell& o) const { return first == o.first && second == o.second && period == o.period; }
+        };
+
+        const Faculty& in;
+        const Timetable& out;
+        vector<unsigned> scheduled; // number of lectures of each course
+        vector<Cell> conflicts; // (course, course, period), sorted
+        vector<Cell> occupied; // (period, room, lectures in the room) with more than one lecture, sorted
+        vector<Cell> isolated; // (curriculum, -, period) with isolated lectures, sorted
+        ValidationCosts costs;
+    private:
+        static void SortUnique(vector<Cell>& cells) {
+            sort(cells.begin(), cells.end());
+            cells.erase(unique(cells.begin(), cells.end()), cells.end());
+        }
+
+        // Isolated cells of every curriculum, in order, and the lectures held in
+        // them, from the curricula's period sets; with plain period bits tested
+        // cell by cell if the instance's days do not fit the bitmask layout
+        void FindIsolated() {
+            DayLayout layout(in.PeriodsPerDay(), in.Days());
+            unsigned g, i, w, p;
+            if (!layout.Supported()) {
+                unsigned words = in.PeriodWords(), ppd = in.PeriodsPerDay();
+                vector<uint64_t> periods(in.Curricula() * words, 0);
+                auto busy = [&](unsigned g, unsigned p) { return periods[g * words + p / 64] >> (p % 64) & 1; };
+                for (i = 0; i < out.LecturesNo(); i++) {
+                    const ScheduledLecture& l = out.Lecture(i);
+                    for (const unsigned* pg = in.CourseCurriculaBegin(l.course); pg != in.CourseCurriculaEnd(l.course); ++pg)
+                        periods[*pg * words + l.period / 64] |= uint64_t(1) << (l.period % 64);
+                }
+                for (i = 0; i < out.LecturesNo(); i++) {
+                    p = out.Lecture(i).period;
+                    for (const unsigned* pg = in.CourseCurriculaBegin(out.Lecture(i).course); pg != in.CourseCurriculaEnd(out.Lecture(i).course); ++pg)
+                        if ((p % ppd == 0 || !busy(*pg, p - 1)) && (p % ppd == ppd - 1 || !busy(*pg, p + 1))) {
+                            isolated.push_back({*pg, 0, p});
+                            costs.curriculum_compactness++;
+                        }
+                }
+                SortUnique(isolated);
+                return;
+            }
+
+            vector<uint64_t> periods(in.Curricula() * layout.Words(), 0);
+            for (i = 0; i < out.LecturesNo(); i++) {
+                const ScheduledLecture& l = out.Lecture(i);
+                for (const unsigned* pg = in.CourseCurriculaBegin(l.course); pg != in.CourseCurriculaEnd(l.course); ++pg)
+                    periods[*pg * layout.Words() + layout.Word(l.period)] |= layout.Bit(l.period);
+            }
+            for (i = 0; i < out.LecturesNo(); i++) {
+                const ScheduledLecture& l = out.Lecture(i);
+                for (const unsigned* pg = in.CourseCurriculaBegin(l.course); pg != in.CourseCurriculaEnd(l.course); ++pg)
+                    if (isolated_periods(periods[*pg * layout.Words() + layout.Word(l.period)], layout.First(), layout.Last()) & layout.Bit(l.period))
+                        costs.curriculum_compactness++;
+            }
+            for (g = 0; g < in.Curricula(); g++)
+                for (w = 0; w < layout.Words(); w++)
+                    for (uint64_t bits = isolated_periods(periods[g * layout.Words() + w], layout.First(), layout.Last()); bits; bits &= bits - 1)
+                        isolated.push_back({g, 0, layout.Period(w, __builtin_ctzll(bits))});
+        }
+
+        void ComputeCosts() {
+            vector<unsigned> period_start(in.Periods() + 1, 0), by_period(out.LecturesNo());
+            vector<unsigned> course_period(in.Courses(), UINT_MAX); // period of the course's lecture being scanned
+            vector<unsigned> room_lectures(in.Rooms() + 1, 0); // lectures per room in the period being scanned
+            unsigned c, i, k, p;
+
+            costs = ValidationCosts();
+            // lectures grouped by period (counting sort)
+            for (i = 0; i < out.LecturesNo(); i++)
+                period_start[out.Lecture(i).period + 1]++;
+            for (p = 0; p < in.Periods(); p++)
+                period_start[p + 1] += period_start[p];
+            vector<unsigned> next(period_start.begin(), period_start.end() - 1);
+            for (i = 0; i < out.LecturesNo(); i++)
+                by_period[next[out.Lecture(i).period]++] = i;
+
+            for (p = 0; p < in.Periods(); p++) {
+                for (k = period_start[p]; k < period_start[p + 1]; k++) {
+                    const ScheduledLecture& l = out.Lecture(by_period[k]);
+                    for (const unsigned* pc = in.ConflictsBegin(l.course); pc != in.ConflictsEnd(l.course); ++pc)
+                        if (course_period[*pc] == p)
+                            conflicts.push_back({min(*pc, l.course), max(*pc, l.course), p});
+                    course_period[l.course] = p;
+                    room_lectures[l.room]++;
+                }
+                for (k = period_start[p]; k < period_start[p + 1]; k++) {
+                    unsigned r = out.Lecture(by_period[k]).room;
+                    if (room_lectures[r] > 1) {
+                        occupied.push_back({p, r, room_lectures[r]});
+                        costs.room_occupation += room_lectures[r] - 1;
+                    }
+                    room_lectures[r] = 0;
+                }
+            }
+
+            for (i = 0; i < out.LecturesNo(); i++) {
+                const ScheduledLecture& l = out.Lecture(i);
+                scheduled[l.course]++;
+                if (!in.Available(l.course, l.period))
+                    costs.availability++;
+                if (in.Capacity(l.room) < in.Students(l.course))
+                    costs.room_capacity += in.Students(l.course) - in.Capacity(l.room);
+            }
+            sort(conflicts.begin(), conflicts.end());
+            sort(occupied.begin(), occupied.end());
+            FindIsolated();
+
+            costs.conflicts = conflicts.size();
+            for (c = 0; c < in.Courses(); c++) {
+                costs.lectures += scheduled[c] > in.Lectures(c) ? scheduled[c] - in.Lectures(c) : in.Lectures(c) - scheduled[c];
+                if (out.WorkingDays(c) < in.MinWorkingDays(c))
+                    costs.min_working_days += in.MinWorkingDays(c) - out.WorkingDays(c);
+                if (out.UsedRoomsNo(c) > 1)
+                    costs.room_stability += out.UsedRoomsNo(c) - 1;
+            }
+        }
+
+        void PrintViolationsOnLectures(std::ostream& os) const {
+            unsigned c;
+            for (c = 0; c < in.Courses(); c++) {
+                if (scheduled[c] < in.Lectures(c)) {
+                    os << "[H] Too few lectures for course " << in.CourseVector(c).Name() << endl;
+                } else if (scheduled[c] > in.Lectures(c)) {
+                    os << "[H] Too many lectures for course " << in.CourseVector(c).Name() << endl;
+                }
+            }
+        }
+
+        void PrintViolationsOnConflicts(std::ostream& os) const {
+            unsigned i, p;
+            for (i = 0; i < conflicts.size(); i++) {
+                p = conflicts[i].period;
+                os << "[H] Courses " << in.CourseVector(conflicts[i].first).Name() << " and " << in.CourseVector(conflicts[i].second).Name() << " have both a lecture at period " << p << " (day " << p/in.PeriodsPerDay() << ", timeslot " << p % in.PeriodsPerDay() << ")" << endl;
+            }
+        }
+
+        void PrintViolationsOnAvailability(std::ostream& os) const {
+            unsigned i, c, p;
+            for (i = 0; i < out.LecturesNo(); i++) {
+                c = out.Lecture(i).course;
+                p = out.Lecture(i).period;
+                if (!in.Available(c, p)) {
+                    os << "[H] Course " << in.CourseVector(c).Name() << " has a lecture at unavailable period " << p << " (day " << p/in.PeriodsPerDay() << ", timeslot " << p % in.PeriodsPerDay() << ")" << std::endl;
+                }
+            }
+        }
+
+        void PrintViolationsOnRoomOccupation(std::ostream& os) const {
+            unsigned i, r, p, n;
+            for (i = 0; i < occupied.size(); i++) {
+                p = occupied[i].first;
+                r = occupied[i].second;
+                n = occupied[i].period;
+                os << "[H] " << n << " lectures in room " << in.RoomVector(r).Name() << " the period " << p << " (day " << p/in.PeriodsPerDay() << ", timeslot " << p % in.PeriodsPerDay() << ")"; 
+                if (n > 2) {
+                    os << " [" << n - 1 << " violations]";
+                }
+                os << endl;
+            }
+        }
+
+        void PrintViolationsOnRoomCapacity(std::ostream& os) const {
+            unsigned i, c, p, r;
+            for (i = 0; i < out.LecturesNo(); i++) {
+                c = out.Lecture(i).course;
+                p = out.Lecture(i).period;
+                r = out.Lecture(i).room;
+                if (in.Capacity(r) < in.Students(c)) {
+                    os << "[S(" << in.Students(c) - in.Capacity(r) << ")] Room " << in.RoomVector(r).Name() << " too small for course " << in.CourseVector(c).Name() << " the period " << p << " (day " << p/in.PeriodsPerDay() << ", timeslot " << p % in.PeriodsPerDay() << ")" << endl;
+                }
+            }
+        }
+
+        void PrintViolationsOnMinWorkingDays(std::ostream& os) const {
+            unsigned c;
+            for (c = 0; c < in.Courses(); c++) {
+                if (out.WorkingDays(c) < in.MinWorkingDays(c)) {
+                    os << "[S(" << in.MIN_WORKING_DAYS_COST << ")] The course " << in.CourseVector(c).Name() << " has only " << out.WorkingDays(c) << " days of lecture" << std::endl;
+                }
+            }
+        }
+
+        void PrintViolationsOnCurriculumCompactness(std::ostream& os) const {
+            unsigned i, g, p;
+            for (i = 0; i < isolated.size(); i++) {
+                g = isolated[i].first;
+                p = isolated[i].period;
+                os << "[S(" << in.CURRICULUM_COMPACTNESS_COST << ")] Curriculum " << in.CurriculaVector(g).Name() << " has an isolated lecture at period " << p << " (day " << p/in.PeriodsPerDay() << ", timeslot " << p % in.PeriodsPerDay() << ")" << endl;
+            }
+        }
+
+        void PrintViolationsOnRoomStability(std::ostream& os) const {
+            unsigned c;
+            for (c = 0; c < in.Courses(); c++) {
+                if (out.UsedRoomsNo(c) > 1) {
+                    os << "[S(" << (out.UsedRoomsNo(c) - 1) * in.ROOM_STABILITY_COST << ")] Course " << in.CourseVector(c).Name() << " uses " << out.UsedRoomsNo(c) << " different rooms" << std::endl;
+                }
+            }
+        }
+
+    public:
+        Validator(const Faculty& f, const Timetable& t) : in(f), out(t), scheduled(in.Courses(), 0) {
+            ComputeCosts();
+        }
+
+        const ValidationCosts& Costs() const { return costs; }
+        
+        void PrintCosts(ostream& os) const {
+            os << "Violations of Lectures (hard) : " << costs.lectures << endl;
+            os << "Violations of Conflicts (hard) : " << costs.conflicts << endl;
+            os << "Violations of Availability (hard) : " << costs.availability << endl;
+            os << "Violations of RoomOccupation (hard) : " << costs.room_occupation << endl;
+            os << "Cost of RoomCapacity (soft) : " << costs.room_capacity << endl;
+            os << "Cost of MinWorkingDays (soft) : " << costs.min_working_days * in.MIN_WORKING_DAYS_COST << endl;
+            os << "Cost of CurriculumCompactness (soft) : " << costs.curriculum_compactness * in.CURRICULUM_COMPACTNESS_COST << endl;
+            os << "Cost of RoomStability (soft) : " << costs.room_stability * in.ROOM_STABILITY_COST << endl;
+        }
+
+        void PrintViolations(ostream& os) const {
+            PrintViolationsOnLectures(os);
+            PrintViolationsOnConflicts(os);
+            PrintViolationsOnAvailability(os);
+            PrintViolationsOnRoomOccupation(os);
+            PrintViolationsOnRoomCapacity(os);
+            PrintViolationsOnMinWorkingDays(os);
+            PrintViolationsOnCurriculumCompactness(os);
+            PrintViolationsOnRoomStability(os);
+        }
+        
+        unsigned TotalViolations() const {
+            return costs.lectures + costs.conflicts + costs.availability + costs.room_occupation;
+        }
+
+        unsigned TotalCost() const {
+            return costs.room_capacity + costs.min_working_days * in.MIN_WORKING_DAYS_COST
+               + costs.curriculum_compactness * in.CURRICULUM_COMPACTNESS_COST + costs.room_stability * in.ROOM_STABILITY_COST;
+        }
+
+        void PrintTotalCost(ostream& os) const {
+            unsigned violations = TotalViolations();
+            if (violations > 0)
+                os << "Violations = " << violations << ", ";
+            os << "Total Cost = " << TotalCost() << endl;
+        }    
+};
+
+#endif